@@ -0,0 +1,1207 @@
+/*
+ * Kernel microbenchmarks. Each primitive is driven in a tight loop and timed
+ * with os_port_get_cycles(), which counts CPU cycles on Cortex-M3 (DWT) and
+ * RISC-V (mcycle), and nanoseconds on the POSIX port.
+ *
+ * Under QEMU:
+ *   cmake -B build_bench -DCMAKE_TOOLCHAIN_FILE=gcc-arm-none-eabi.cmake \
+ *         -DSEAL_BOARD=lm3s6965
+ *   qemu-system-arm -M lm3s6965evb -nographic -semihosting \
+ *                   -kernel build_bench/seal_bench.elf
+ *
+ * The Cortex-M4F port is benchmarked the same way with
+ * -DSEAL_PORT=cortex_m4f -DSEAL_BOARD=mps2_an386 and -M mps2-an386. It also
+ * checks that the FPU registers of a task survive preemption. The Cortex-M0
+ * port uses -DSEAL_PORT=cortex_m0 -DSEAL_BOARD=microbit and -M microbit.
+ *
+ * Configuring with -DSEAL_BENCH_STATS=ON enables OS_CFG_ENABLE_STATS. The
+ * switch rows of such a build, compared with a default one, give the cost of
+ * the accounting done on every switch. It also times the snapshot and prints
+ * the statistics of every task at the end.
+ *
+ * -DSEAL_BENCH_TRACE=ON enables OS_CFG_ENABLE_TRACE and times a single trace
+ * record. On the POSIX port the trace buffer is then written to
+ * seal_trace.bin, for tools/trace2json.py.
+ *
+ * -DSEAL_BENCH_STACK_FILL=NONE, BOOT or IDLE selects OS_CFG_STACK_FILL. The
+ * time from os_init() to the first task shows what the fill costs at boot.
+ *
+ * -DSEAL_BENCH_CRITICAL=ON enables OS_CFG_ENABLE_CRITICAL_PROFILER. The
+ * critical section row then includes the profiling, and every critical section
+ * site entered during the run is printed at the end. Pipe the output through
+ * tools/critprof.py to rank the sites by their longest masked time.
+ *
+ * -DSEAL_BENCH_STACK_GUARD=ON enables OS_CFG_ENABLE_STACK_GUARD on the
+ * Cortex-M3 and M4F ports. Compared with a default build, the switch rows give
+ * the cost of moving the guard. At the end the benchmark task overflows its
+ * stack on purpose and passes if the guard catches it.
+ *
+ * The table reads rows let 1 to OS_CFG_DYNAMIC_TASK_CNT pool tasks read a
+ * shared table, under the reader-writer lock and under the mutex. The readers
+ * share a priority level, so on a single core the lock only matters when a
+ * slice ends while it's held. Then the other readers queue up behind the
+ * mutex, but not behind the rwlock. The micro:bit build has 2 pool tasks.
+ *
+ * The RV32 port runs on QEMU virt:
+ *   make rv32
+ *   qemu-system-riscv32 -M virt -bios none -nographic \
+ *                       -kernel build_rv32/seal_bench.elf
+ *
+ * The systick rows put 4 to 256 tasks on the delayed list. The list stores
+ * the delay of each task relative to the one before it, so the systick only
+ * decrements its head and the rows stay flat.
+ *
+ * The contended mutex rows time a give and a take while 1, 8 and 64 tasks
+ * wait for the mutex, 8 at most on the micro:bit. Waiters are kept in a
+ * single list sorted by priority, so picking the next holder doesn't depend
+ * on how many there are.
+ *
+ * -DSEAL_BENCH_WIDE_PRIORITIES=ON moves the top priority from 4 to 63, so the
+ * ready priorities are kept in the two-level bitmap instead of a single word.
+ * The highest ready priority row times the lookup done by every scheduling
+ * decision. Only the ready queues grow with the level count, by 8 bytes per
+ * level on 32-bit targets.
+ *
+ * -DSEAL_BENCH_TICKLESS=ON enables OS_CFG_ENABLE_TICKLESS_IDLE and checks that
+ * sleeps of 2 to 1000 systicks last as long as asked for. Each is measured in
+ * the systicks the kernel accounts, which include the ones caught up in one
+ * batch after a stretched SysTick period, and in cycles against the median
+ * period of 1-systick sleeps.
+ */
+#include "private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_SAMPLE_CNT 128U
+#define BENCH_RING_BATCH 16U
+#define BENCH_SLEEPER_DELAY 0x7fffffffUL
+#define BENCH_SLEEPER_CNT 4U
+#define BENCH_LOOKUP_BATCH 16U
+#define BENCH_FLAGS_WAITER_CNT 4U
+#define BENCH_FLAGS_ALL 0xfUL
+#define BENCH_POOL_BLOCK_SIZE 64U
+#define BENCH_POOL_BATCH 16U
+
+#define BENCH_FPU_PREEMPTIONS 8U
+#define BENCH_SPIN_TASK_CNT 3U
+#define BENCH_SPIN_TICKS 400U
+#define BENCH_TIMER_PERIOD 2U
+#define BENCH_TICKER_STACK 512U
+#define BENCH_TABLE_WORDS 64U
+#define BENCH_READER_CNT OS_CFG_DYNAMIC_TASK_CNT
+#define BENCH_READ_TICKS 50U
+
+#if defined(__ARM_FP)
+#define BENCH_FPU_CHECK 1
+#else
+#define BENCH_FPU_CHECK 0
+#endif
+
+#ifndef BENCH_SEMIHOSTING
+#define BENCH_SEMIHOSTING 0
+#endif
+
+#ifndef BENCH_DELAYED_TASK_CNT
+#define BENCH_DELAYED_TASK_CNT 256U
+#endif
+
+#if BENCH_SEMIHOSTING
+void initialise_monitor_handles(void);
+#endif
+
+typedef enum {
+  BENCH_MODE_NONE,
+  BENCH_MODE_WAKE,
+  BENCH_MODE_MUTEX,
+  BENCH_MODE_MSGQ,
+  BENCH_MODE_RING,
+  BENCH_MODE_FPU_CHECK,
+  BENCH_MODE_NOTIFY,
+  BENCH_MODE_NOTIFY_ISR,
+} bench_mode_t;
+
+static os_u32_t bench_samples[BENCH_SAMPLE_CNT];
+static os_u32_t bench_take_samples[BENCH_SAMPLE_CNT];
+static os_u32_t bench_overhead;
+static volatile os_u32_t bench_start;
+static volatile os_size_t bench_idx;
+static volatile bench_mode_t bench_mode;
+static volatile os_bool_t bench_contending;
+static volatile os_u8_t bench_prio_sink;
+static volatile os_size_t bench_flags_woken;
+static volatile os_bool_t bench_fpu_checking;
+static volatile os_u32_t bench_fpu_clobbers;
+static volatile os_u32_t bench_spin_counts[BENCH_SPIN_TASK_CNT];
+static volatile os_bool_t bench_spin_stop;
+static volatile os_u32_t bench_timer_last;
+static volatile os_size_t bench_timer_idx;
+static os_u32_t bench_table[BENCH_TABLE_WORDS];
+static volatile os_u32_t bench_table_sum;
+static volatile os_u32_t bench_read_counts[BENCH_READER_CNT];
+static volatile os_bool_t bench_read_rwlock;
+static os_u32_t bench_boot_start;
+static os_u32_t bench_boot_cycles;
+static os_tcb_t bench_delayed[BENCH_DELAYED_TASK_CNT];
+#if OS_CFG_ENABLE_TICKLESS_IDLE
+static os_tcb_t bench_tick_probe;
+#endif
+
+#if BENCH_FPU_CHECK
+#define BENCH_FPU_REGS 32U
+#define BENCH_FPU_CLOBBERS                                                     \
+  "s0", "s1", "s2", "s3", "s4", "s5", "s6", "s7", "s8", "s9", "s10", "s11",    \
+      "s12", "s13", "s14", "s15", "s16", "s17", "s18", "s19", "s20", "s21",    \
+      "s22", "s23", "s24", "s25", "s26", "s27", "s28", "s29", "s30", "s31"
+
+/**
+ * @brief Overwrites all FPU registers.
+ */
+static void _fpu_fill(const os_u32_t *regs) {
+  __asm volatile("vldmia %0, {s0-s31} \n" ::"r"(regs)
+                 : BENCH_FPU_CLOBBERS, "memory");
+}
+
+/**
+ * @brief Loads all FPU registers, spins until the FPU task has preempted us
+ * enough times, then stores them back.
+ */
+static void _fpu_hold(const os_u32_t *in, os_u32_t *out, os_u32_t clobbers) {
+  os_u32_t tmp;
+  __asm volatile("vldmia %[in], {s0-s31}    \n"
+                 "1:                        \n"
+                 "ldr %[tmp], [%[cnt]]      \n"
+                 "cmp %[tmp], %[clobbers]   \n"
+                 "blo 1b                    \n"
+                 "vstmia %[out], {s0-s31}   \n"
+                 : [tmp] "=&r"(tmp)
+                 : [in] "r"(in), [out] "r"(out), [clobbers] "r"(clobbers),
+                   [cnt] "r"(&bench_fpu_clobbers)
+                 : BENCH_FPU_CLOBBERS, "cc", "memory");
+}
+#endif
+
+/**
+ * @brief Sorts the samples and prints a row of the results table.
+ */
+static void _report(const char *name) {
+  os_u64_t sum = 0;
+  for (os_size_t i = 1; i < BENCH_SAMPLE_CNT; i++) {
+    os_u32_t sample = bench_samples[i];
+    os_size_t j = i;
+    while ((j > 0) && (bench_samples[j - 1] > sample)) {
+      bench_samples[j] = bench_samples[j - 1];
+      j--;
+    }
+    bench_samples[j] = sample;
+  }
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    bench_samples[i] = (bench_samples[i] > bench_overhead)
+                           ? bench_samples[i] - bench_overhead
+                           : 0;
+    sum += bench_samples[i];
+  }
+  printf("%-30s %8lu %8lu %8lu %8lu %8lu %8lu\n", name,
+         (unsigned long)bench_samples[0],
+         (unsigned long)(sum / BENCH_SAMPLE_CNT),
+         (unsigned long)bench_samples[BENCH_SAMPLE_CNT / 2],
+         (unsigned long)bench_samples[(BENCH_SAMPLE_CNT * 9) / 10],
+         (unsigned long)bench_samples[(BENCH_SAMPLE_CNT * 99) / 100],
+         (unsigned long)bench_samples[BENCH_SAMPLE_CNT - 1]);
+}
+
+/**
+ * @brief Measures the cost of reading the counter itself.
+ */
+static void _bench_overhead(void) {
+  bench_overhead = 0xffffffffUL;
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_u32_t start = os_port_get_cycles();
+    os_u32_t delta = os_port_get_cycles() - start;
+    if (delta < bench_overhead) {
+      bench_overhead = delta;
+    }
+  }
+}
+
+static void _bench_semaphore(void) {
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_u32_t start = os_port_get_cycles();
+    os_semaphore_give(OS_SEMAPHORE_ID_BENCH);
+    os_semaphore_take(OS_SEMAPHORE_ID_BENCH, 0);
+    bench_samples[i] = os_port_get_cycles() - start;
+  }
+  _report("semaphore give+take");
+}
+
+static void _bench_notify(void) {
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_u32_t start = os_port_get_cycles();
+    os_task_notify_give(OS_TASK_ID_BENCH);
+    os_task_notify_wait(OS_FALSE, 0, OS_NULL);
+    bench_samples[i] = os_port_get_cycles() - start;
+  }
+  _report("notify give+wait");
+}
+
+static void _bench_mutex(void) {
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_u32_t start = os_port_get_cycles();
+    os_mutex_take(OS_MUTEX_ID_BENCH, 0);
+    os_mutex_give(OS_MUTEX_ID_BENCH);
+    bench_samples[i] = os_port_get_cycles() - start;
+  }
+  _report("mutex take+give");
+}
+
+static void _bench_rwlock(void) {
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_u32_t start = os_port_get_cycles();
+    os_rwlock_read_take(OS_RWLOCK_ID_BENCH, 0);
+    os_rwlock_read_give(OS_RWLOCK_ID_BENCH);
+    bench_samples[i] = os_port_get_cycles() - start;
+  }
+  _report("rwlock read take+give");
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_u32_t start = os_port_get_cycles();
+    os_rwlock_write_take(OS_RWLOCK_ID_BENCH, 0);
+    os_rwlock_write_give(OS_RWLOCK_ID_BENCH);
+    bench_samples[i] = os_port_get_cycles() - start;
+  }
+  _report("rwlock write take+give");
+}
+
+static void _bench_wake(void) {
+  bench_mode = BENCH_MODE_WAKE;
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    bench_idx = i;
+    bench_start = os_port_get_cycles();
+    os_semaphore_give(OS_SEMAPHORE_ID_BENCH_WAKE);
+  }
+  _report("semaphore give to wake");
+}
+
+static void _bench_notify_wake(void) {
+  bench_mode = BENCH_MODE_NOTIFY;
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    bench_idx = i;
+    /* the waiter waits for a notification */
+    os_semaphore_give(OS_SEMAPHORE_ID_BENCH_WAKE);
+    bench_start = os_port_get_cycles();
+    os_task_notify_give(OS_TASK_ID_BENCH_WAITER);
+  }
+  _report("notify give to wake");
+}
+
+static void _bench_mutex_handoff(void) {
+  bench_mode = BENCH_MODE_MUTEX;
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    bench_idx = i;
+    os_mutex_take(OS_MUTEX_ID_BENCH, 0);
+    /* the waiter blocks on the mutex */
+    os_semaphore_give(OS_SEMAPHORE_ID_BENCH_WAKE);
+    bench_start = os_port_get_cycles();
+    os_mutex_give(OS_MUTEX_ID_BENCH);
+  }
+  _report("mutex hand-off");
+}
+
+/**
+ * @brief Times a give and a take of the mutex while 1, 8 and up to
+ * BENCH_CONTENDER_CNT contenders wait for it. The give hands the mutex to the
+ * first contender without a switch. The take blocks, lends the priority of
+ * the benchmark task to the contender and returns once it has given the mutex
+ * back. The contender queues up again while the benchmark task sleeps.
+ */
+static void _bench_contention(void) {
+  char name[32];
+  for (os_size_t cnt = 1; cnt <= BENCH_CONTENDER_CNT; cnt *= 8U) {
+    os_mutex_take(OS_MUTEX_ID_BENCH, 0);
+    bench_contending = OS_TRUE;
+    for (os_size_t i = 0; i < cnt; i++) {
+      os_semaphore_give(OS_SEMAPHORE_ID_BENCH_CONTEND);
+    }
+    for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+      /* let all of them block on the mutex */
+      os_sleep(1);
+      os_u32_t start = os_port_get_cycles();
+      os_mutex_give(OS_MUTEX_ID_BENCH);
+      os_u32_t given = os_port_get_cycles();
+      os_mutex_take(OS_MUTEX_ID_BENCH, 0);
+      bench_samples[i] = given - start;
+      bench_take_samples[i] = os_port_get_cycles() - given;
+    }
+    snprintf(name, sizeof(name), "mutex give, %lu waiting", (unsigned long)cnt);
+    _report(name);
+    for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+      bench_samples[i] = bench_take_samples[i];
+    }
+    snprintf(name, sizeof(name), "mutex take, %lu waiting", (unsigned long)cnt);
+    _report(name);
+    /* let them get the mutex once more and go back to waiting */
+    bench_contending = OS_FALSE;
+    os_mutex_give(OS_MUTEX_ID_BENCH);
+    os_sleep(1);
+  }
+}
+
+/**
+ * @brief Times a batch of highest ready priority lookups. The bitmap is read
+ * through a volatile pointer, so that every lookup is done again.
+ */
+static void _bench_priority_lookup(void) {
+  const volatile os_prio_bitmap_t *ready = &os_ctx.ready_priorities;
+  char name[40];
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_u32_t start = os_port_get_cycles();
+    for (os_size_t j = 0; j < BENCH_LOOKUP_BATCH; j++) {
+      bench_prio_sink = OS_BITMAP_GET_HIGHEST(*ready);
+    }
+    bench_samples[i] = os_port_get_cycles() - start;
+  }
+  snprintf(name, sizeof(name), "highest prio x%u, %u levels",
+           BENCH_LOOKUP_BATCH, (unsigned)OS_PRIORITY_LEVEL_CNT);
+  _report(name);
+}
+
+/**
+ * @brief Fills a message queue and drains it again, one sample is the average
+ * cost of a single send and receive.
+ */
+static void _bench_msgq(os_event_id_t id, os_size_t depth, const char *name) {
+  os_u32_t msg = 0;
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_u32_t start = os_port_get_cycles();
+    for (os_size_t j = 0; j < depth; j++) {
+      os_msgq_send(id, &msg, 0);
+    }
+    for (os_size_t j = 0; j < depth; j++) {
+      os_msgq_receive(id, &msg, 0);
+    }
+    bench_samples[i] = (os_port_get_cycles() - start) / depth;
+  }
+  _report(name);
+}
+
+static void _bench_msgq_handoff(void) {
+  os_u32_t msg = 0;
+  bench_mode = BENCH_MODE_MSGQ;
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    bench_idx = i;
+    /* the waiter blocks on the message queue */
+    os_semaphore_give(OS_SEMAPHORE_ID_BENCH_WAKE);
+    bench_start = os_port_get_cycles();
+    os_msgq_send(OS_MSGQ_ID_BENCH_1, &msg, 0);
+  }
+  _report("msgq send to waiting receiver");
+}
+
+/**
+ * @brief One sample is the average cost of writing and reading a record.
+ */
+static void _bench_ring(void) {
+  os_u32_t records[BENCH_RING_BATCH] = {0};
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_u32_t start = os_port_get_cycles();
+    for (os_size_t j = 0; j < BENCH_RING_BATCH; j++) {
+      os_ring_write(OS_RING_ID_BENCH, &records[j], 1);
+    }
+    os_ring_read(OS_RING_ID_BENCH, records, BENCH_RING_BATCH);
+    bench_samples[i] = (os_port_get_cycles() - start) / BENCH_RING_BATCH;
+  }
+  _report("ring write+read");
+}
+
+/**
+ * @brief Records are written one by one and the consumer is woken up once
+ * per batch. One sample is the cost per record until the consumer drained
+ * the batch.
+ */
+static void _bench_ring_batch(void) {
+  os_u32_t record = 0;
+  bench_mode = BENCH_MODE_RING;
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    bench_idx = i;
+    /* the waiter blocks on the ring buffer */
+    os_semaphore_give(OS_SEMAPHORE_ID_BENCH_WAKE);
+    bench_start = os_port_get_cycles();
+    for (os_size_t j = 0; j < BENCH_RING_BATCH; j++) {
+      os_ring_write(OS_RING_ID_BENCH, &record, 1);
+    }
+  }
+  _report("ring batch to waiter, per rec");
+}
+
+/**
+ * @brief A single set wakes up all flag waiters, each consuming its own flag.
+ * One sample lasts until the last of them is running.
+ */
+static void _bench_flags_broadcast(void) {
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    bench_idx = i;
+    bench_flags_woken = 0;
+    bench_start = os_port_get_cycles();
+    os_flags_set(OS_FLAGS_ID_BENCH, BENCH_FLAGS_ALL);
+  }
+  _report("flags set to wake 4 waiters");
+}
+
+/**
+ * @brief ISR-side cost of waking a task, which is what the ISR spends with
+ * interrupts masked when it calls the kernel directly. The wake-up itself
+ * happens in os_exit_isr().
+ */
+static void _bench_isr_give(void) {
+  bench_mode = BENCH_MODE_NONE;
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_enter_isr();
+    os_u32_t start = os_port_get_cycles();
+    os_semaphore_give(OS_SEMAPHORE_ID_BENCH_WAKE);
+    bench_samples[i] = os_port_get_cycles() - start;
+    os_exit_isr();
+  }
+  _report("isr semaphore give, in isr");
+}
+
+static void _bench_isr_notify(void) {
+  bench_mode = BENCH_MODE_NOTIFY_ISR;
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_semaphore_give(OS_SEMAPHORE_ID_BENCH_WAKE);
+    os_enter_isr();
+    os_u32_t start = os_port_get_cycles();
+    os_task_notify_give(OS_TASK_ID_BENCH_WAITER);
+    bench_samples[i] = os_port_get_cycles() - start;
+    os_exit_isr();
+  }
+  _report("isr notify give, in isr");
+}
+
+/**
+ * @brief ISR-side cost of a deferred give. Posting doesn't mask interrupts.
+ */
+static void _bench_isr_post(void) {
+  bench_mode = BENCH_MODE_NONE;
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_enter_isr();
+    os_u32_t start = os_port_get_cycles();
+    os_isr_post(OS_ISR_POST_SEMAPHORE_GIVE, OS_SEMAPHORE_ID_BENCH_WAKE, 0);
+    bench_samples[i] = os_port_get_cycles() - start;
+    os_exit_isr();
+  }
+  _report("isr post, in isr");
+}
+
+static void _bench_isr_post_wake(void) {
+  bench_mode = BENCH_MODE_WAKE;
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    bench_idx = i;
+    os_enter_isr();
+    bench_start = os_port_get_cycles();
+    os_isr_post(OS_ISR_POST_SEMAPHORE_GIVE, OS_SEMAPHORE_ID_BENCH_WAKE, 0);
+    os_exit_isr();
+  }
+  _report("isr post to wake");
+}
+
+static void _bench_pool(void) {
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_u32_t start = os_port_get_cycles();
+    void *block = os_pool_try_alloc(OS_POOL_ID_BENCH);
+    os_pool_free(OS_POOL_ID_BENCH, block);
+    bench_samples[i] = os_port_get_cycles() - start;
+  }
+  _report("pool alloc+free");
+}
+
+static void _bench_malloc(void) {
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_u32_t start = os_port_get_cycles();
+    void *block = malloc(BENCH_POOL_BLOCK_SIZE);
+    free(block);
+    bench_samples[i] = os_port_get_cycles() - start;
+  }
+  _report("malloc+free");
+}
+
+/**
+ * @brief Drains the whole pool and fills it back, one sample is the average
+ * cost of a single alloc and free.
+ */
+static void _bench_pool_batch(void) {
+  void *blocks[BENCH_POOL_BATCH];
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_u32_t start = os_port_get_cycles();
+    for (os_size_t j = 0; j < BENCH_POOL_BATCH; j++) {
+      os_pool_alloc(OS_POOL_ID_BENCH, &blocks[j], 0);
+    }
+    for (os_size_t j = 0; j < BENCH_POOL_BATCH; j++) {
+      os_pool_free(OS_POOL_ID_BENCH, blocks[j]);
+    }
+    bench_samples[i] = (os_port_get_cycles() - start) / BENCH_POOL_BATCH;
+  }
+  _report("pool alloc+free x16, per blk");
+}
+
+static void _bench_malloc_batch(void) {
+  void *blocks[BENCH_POOL_BATCH];
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_u32_t start = os_port_get_cycles();
+    for (os_size_t j = 0; j < BENCH_POOL_BATCH; j++) {
+      blocks[j] = malloc(BENCH_POOL_BLOCK_SIZE);
+    }
+    for (os_size_t j = 0; j < BENCH_POOL_BATCH; j++) {
+      free(blocks[j]);
+    }
+    bench_samples[i] = (os_port_get_cycles() - start) / BENCH_POOL_BATCH;
+  }
+  _report("malloc+free x16, per blk");
+}
+
+/**
+ * @brief Entry of the tasks spawned from the task pool, they exit right away.
+ */
+static void _bench_worker_entry(void *param) { OS_UNUSED(param); }
+
+/**
+ * @brief Spawns a task that preempts the benchmark task and exits, i.e. a full
+ * round trip through the task pool with two switches.
+ */
+static void _bench_task_spawn(void) {
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_u32_t start = os_port_get_cycles();
+    os_task_create(OS_NULL, 3, _bench_worker_entry, OS_NULL);
+    bench_samples[i] = os_port_get_cycles() - start;
+  }
+  _report("task spawn+exit");
+}
+
+static void _bench_task_create_delete(void) {
+  os_task_id_t id;
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_u32_t start = os_port_get_cycles();
+    os_task_create(&id, 1, _bench_worker_entry, OS_NULL);
+    os_task_delete(id);
+    bench_samples[i] = os_port_get_cycles() - start;
+  }
+  _report("task create+delete, no run");
+}
+
+
+/**
+ * @brief Same as the plain wake-up, but the woken task has used the FPU, so
+ * s16-s31 are restored on the way in.
+ */
+static void _bench_wake_fpu(void) {
+  bench_mode = BENCH_MODE_WAKE;
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    bench_idx = i;
+    bench_start = os_port_get_cycles();
+    os_semaphore_give(OS_SEMAPHORE_ID_BENCH_FPU);
+  }
+  _report("semaphore give to wake, fpu");
+}
+
+#if BENCH_FPU_CHECK
+/**
+ * @brief Holds a pattern in the FPU registers while the FPU task preempts us
+ * on every systick and overwrites them with its own.
+ * @note  It leaves the bench task with an FPU context, so it needs to run
+ * last.
+ */
+static void _bench_fpu_check(void) {
+  os_u32_t in[BENCH_FPU_REGS];
+  os_u32_t out[BENCH_FPU_REGS];
+  for (os_size_t i = 0; i < BENCH_FPU_REGS; i++) {
+    in[i] = 0x3f800000UL + i;
+  }
+  bench_mode = BENCH_MODE_FPU_CHECK;
+  bench_fpu_clobbers = 0;
+  bench_fpu_checking = OS_TRUE;
+  os_semaphore_give(OS_SEMAPHORE_ID_BENCH_FPU);
+  _fpu_hold(in, out, BENCH_FPU_PREEMPTIONS);
+  bench_fpu_checking = OS_FALSE;
+  os_bool_t ok = OS_TRUE;
+  for (os_size_t i = 0; i < BENCH_FPU_REGS; i++) {
+    ok = ok && (in[i] == out[i]);
+  }
+  printf("fpu registers across %u preemptions: %s\n", BENCH_FPU_PREEMPTIONS,
+         ok ? "ok" : "CORRUPTED");
+}
+#endif
+
+/**
+ * @brief Records the interval since the previous call. The first call only
+ * sets the reference point.
+ * @return OS_TRUE once all samples are in
+ */
+static os_bool_t _timer_sample(void) {
+  os_u32_t now = os_port_get_cycles();
+  if (bench_timer_idx != 0) {
+    bench_samples[bench_timer_idx - 1] = now - bench_timer_last;
+  }
+  bench_timer_last = now;
+  return (++bench_timer_idx > BENCH_SAMPLE_CNT) ? OS_TRUE : OS_FALSE;
+}
+
+/**
+ * @brief Samples the periods of a timer, in the service task or in the ISR.
+ */
+static void _bench_timer(os_timer_id_t id, const char *name) {
+  bench_timer_idx = 0;
+  os_timer_start(id, BENCH_TIMER_PERIOD);
+  os_semaphore_take(OS_SEMAPHORE_ID_BENCH_TIMER_DONE, 0);
+  _report(name);
+}
+
+/**
+ * @brief Samples the periods of a task that sleeps in a loop, which is what a
+ * timer replaces.
+ */
+static void _bench_ticker(void) {
+  bench_timer_idx = 0;
+  os_semaphore_give(OS_SEMAPHORE_ID_BENCH_TICKER);
+  os_semaphore_take(OS_SEMAPHORE_ID_BENCH_TIMER_DONE, 0);
+  _report("os_sleep(2) loop period");
+  printf("timer ram: %lu bytes, task ram: %lu bytes + %u bytes of stack\n",
+         (unsigned long)sizeof(os_timer_t), (unsigned long)sizeof(os_tcb_t),
+         BENCH_TICKER_STACK);
+}
+
+/**
+ * @brief Lets the spinners count in a loop, preempting each other only at the
+ * end of their slices, and prints the share of the loops each one got.
+ */
+static void _bench_time_slicing(void) {
+  os_u32_t counts[BENCH_SPIN_TASK_CNT];
+  os_u32_t total = 0;
+  bench_spin_stop = OS_FALSE;
+  for (os_size_t i = 0; i < BENCH_SPIN_TASK_CNT; i++) {
+    bench_spin_counts[i] = 0;
+    os_semaphore_give(OS_SEMAPHORE_ID_BENCH_SPIN);
+  }
+  os_sleep(BENCH_SPIN_TICKS);
+  bench_spin_stop = OS_TRUE;
+  for (os_size_t i = 0; i < BENCH_SPIN_TASK_CNT; i++) {
+    counts[i] = bench_spin_counts[i];
+    total += counts[i];
+  }
+  /* lets the spinners block again */
+  os_sleep(1);
+  if (total == 0) {
+    total = 1;
+  }
+  printf("time slicing shares: %lu%% %lu%% %lu%% (expected 25%% 25%% 50%%), "
+         "%lu loops/tick\n",
+         (unsigned long)(((os_u64_t)counts[0] * 100U) / total),
+         (unsigned long)(((os_u64_t)counts[1] * 100U) / total),
+         (unsigned long)(((os_u64_t)counts[2] * 100U) / total),
+         (unsigned long)(total / BENCH_SPIN_TICKS));
+}
+
+/**
+ * @brief Entry of the pool tasks that read the table in a loop until they're
+ * deleted. They share a priority level, so only the end of a slice preempts
+ * them, often with the lock held.
+ */
+static void _bench_reader_entry(void *param) {
+  volatile os_u32_t *count = &bench_read_counts[(unsigned long)param];
+  while (1) {
+    os_u32_t sum = 0;
+    if (bench_read_rwlock) {
+      os_rwlock_read_take(OS_RWLOCK_ID_BENCH, 0);
+    } else {
+      os_mutex_take(OS_MUTEX_ID_BENCH, 0);
+    }
+    for (os_size_t i = 0; i < BENCH_TABLE_WORDS; i++) {
+      sum += bench_table[i];
+    }
+    if (bench_read_rwlock) {
+      os_rwlock_read_give(OS_RWLOCK_ID_BENCH);
+    } else {
+      os_mutex_give(OS_MUTEX_ID_BENCH);
+    }
+    bench_table_sum = sum;
+    (*count)++;
+  }
+}
+
+/**
+ * @brief Lets a number of readers read the table under a reader-writer lock
+ * or under the mutex for a while, then deletes them.
+ * @return table reads per systick, of all readers together
+ */
+static os_u32_t _read_throughput(os_size_t readers, os_bool_t rwlock) {
+  os_task_id_t ids[BENCH_READER_CNT];
+  os_u32_t total = 0;
+  bench_read_rwlock = rwlock;
+  for (os_size_t i = 0; i < readers; i++) {
+    bench_read_counts[i] = 0;
+    os_task_create(&ids[i], 1, _bench_reader_entry, (void *)(unsigned long)i);
+  }
+  os_sleep(BENCH_READ_TICKS);
+  for (os_size_t i = 0; i < readers; i++) {
+    total += bench_read_counts[i];
+  }
+  /* deleting a reader that holds the lock hands it on */
+  for (os_size_t i = 0; i < readers; i++) {
+    os_task_delete(ids[i]);
+  }
+  return total / BENCH_READ_TICKS;
+}
+
+/**
+ * @brief Compares the read throughput of 1 to BENCH_READER_CNT readers under a
+ * reader-writer lock and under the mutex.
+ */
+static void _bench_readers(void) {
+  char name[32];
+  printf("%-30s %8s %8s\n", "table reads/tick", "rwlock", "mutex");
+  for (os_size_t readers = 1; readers <= BENCH_READER_CNT; readers *= 2) {
+    os_u32_t shared = _read_throughput(readers, OS_TRUE);
+    os_u32_t exclusive = _read_throughput(readers, OS_FALSE);
+    snprintf(name, sizeof(name), "%lu readers", (unsigned long)readers);
+    printf("%-30s %8lu %8lu\n", name, (unsigned long)shared,
+           (unsigned long)exclusive);
+  }
+}
+
+#if OS_CFG_ENABLE_STATS
+static os_task_stats_t bench_task_stats[OS_TASK_SLOT_CNT];
+
+static void _bench_stats_snapshot(void) {
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_u32_t start = os_port_get_cycles();
+    os_task_stats_snapshot(bench_task_stats);
+    bench_samples[i] = os_port_get_cycles() - start;
+  }
+  _report("task stats snapshot");
+}
+
+/**
+ * @brief Prints the statistics of every task, indexed by task id. Free slots
+ * of the task pool are skipped.
+ */
+static void _print_task_stats(void) {
+  os_task_stats_snapshot(bench_task_stats);
+  printf("%-4s %12s %8s %8s %8s %8s\n", "task", "cycles", "vol", "invol",
+         "stack", "used");
+  for (os_size_t i = 0; i < OS_TASK_SLOT_CNT; i++) {
+    if (bench_task_stats[i].stack_size == 0) {
+      continue;
+    }
+    printf("%-4lu %12llu %8lu %8lu %8lu %8lu\n", (unsigned long)i,
+           (unsigned long long)bench_task_stats[i].cycles,
+           (unsigned long)bench_task_stats[i].voluntary_switches,
+           (unsigned long)bench_task_stats[i].involuntary_switches,
+           (unsigned long)bench_task_stats[i].stack_size,
+           (unsigned long)bench_task_stats[i].stack_used_max);
+  }
+}
+#endif
+
+#if OS_CFG_ENABLE_TRACE
+static void _bench_trace(void) {
+  OS_DECLARE_CRITICAL();
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    OS_ENTER_CRITICAL();
+    os_u32_t start = os_port_get_cycles();
+    OS_TRACE(OS_TRACE_SYSTICK, 0);
+    bench_samples[i] = os_port_get_cycles() - start;
+    OS_EXIT_CRITICAL();
+  }
+  _report("trace record");
+}
+
+#if defined(__unix__)
+/**
+ * @brief Writes the raw trace buffer to a file.
+ */
+static void _dump_trace(void) {
+  FILE *file = fopen("seal_trace.bin", "wb");
+  if (file == NULL) {
+    return;
+  }
+  fwrite(&os_trace_buffer, sizeof(os_trace_buffer), 1, file);
+  fclose(file);
+  printf("trace written to seal_trace.bin\n");
+}
+#endif
+#endif
+
+static void _bench_critical(void) {
+  OS_DECLARE_CRITICAL();
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_u32_t start = os_port_get_cycles();
+    OS_ENTER_CRITICAL();
+    OS_EXIT_CRITICAL();
+    bench_samples[i] = os_port_get_cycles() - start;
+  }
+  _report("enter+exit critical section");
+}
+
+#if OS_CFG_ENABLE_CRITICAL_PROFILER
+static void _print_critical_site(const os_critical_site_t *site) {
+  printf("critical %s:%lu %lu %llu %lu\n", site->file,
+         (unsigned long)site->line, (unsigned long)site->count,
+         (unsigned long long)site->total, (unsigned long)site->max);
+}
+#endif
+
+#if OS_CFG_ENABLE_STACK_GUARD
+/**
+ * @brief Recurses until the stack guard stops it. The bound only keeps the
+ * compiler from treating it as endless.
+ */
+static os_u32_t _overflow_stack(os_u32_t depth) {
+  volatile os_u32_t frame[16];
+  frame[0] = depth;
+  if (depth == 0xffffffffUL) {
+    return frame[0];
+  }
+  return _overflow_stack(depth + 1) + frame[0];
+}
+#endif
+
+static void _bench_isr(void) {
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_u32_t start = os_port_get_cycles();
+    os_enter_isr();
+    os_exit_isr();
+    bench_samples[i] = os_port_get_cycles() - start;
+  }
+  _report("isr enter+exit");
+}
+
+/**
+ * @brief Times the systick with 4, 16, 64 and up to BENCH_DELAYED_TASK_CNT
+ * tasks on the delayed list. Past the sleepers, the list is filled with dummy
+ * task structs that never expire.
+ */
+static void _bench_systick(void) {
+  OS_DECLARE_CRITICAL();
+  char name[32];
+  os_size_t dummies = 0;
+  for (os_size_t cnt = BENCH_SLEEPER_CNT; cnt <= BENCH_DELAYED_TASK_CNT;
+       cnt *= 4U) {
+    OS_ENTER_CRITICAL();
+    for (; dummies < (cnt - BENCH_SLEEPER_CNT); dummies++) {
+      bench_delayed[dummies].state = OS_TASK_ASLEEP;
+      os_delay_insert(&bench_delayed[dummies], BENCH_SLEEPER_DELAY);
+    }
+    OS_EXIT_CRITICAL();
+    for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+      OS_ENTER_CRITICAL();
+      os_u32_t start = os_port_get_cycles();
+      os_systick();
+      bench_samples[i] = os_port_get_cycles() - start;
+      OS_EXIT_CRITICAL();
+    }
+    snprintf(name, sizeof(name), "systick, %lu delayed tasks",
+             (unsigned long)cnt);
+    _report(name);
+  }
+  OS_ENTER_CRITICAL();
+  for (os_size_t i = 0; i < dummies; i++) {
+    os_delay_remove(&bench_delayed[i]);
+  }
+  OS_EXIT_CRITICAL();
+}
+
+#if OS_CFG_ENABLE_TICKLESS_IDLE
+/**
+ * @brief Sleeps for the given amount of systicks with a probe task struct on
+ * the delayed list, which counts the systicks the kernel accounts meanwhile,
+ * the ones caught up after a tickless sleep included.
+ * @return the elapsed systicks
+ */
+static os_size_t _probed_sleep(os_size_t ticks, os_u32_t *cycles) {
+  OS_DECLARE_CRITICAL();
+  OS_ENTER_CRITICAL();
+  bench_tick_probe.state = OS_TASK_ASLEEP;
+  os_delay_insert(&bench_tick_probe, BENCH_SLEEPER_DELAY);
+  OS_EXIT_CRITICAL();
+  os_u32_t start = os_port_get_cycles();
+  os_sleep(ticks);
+  *cycles = os_port_get_cycles() - start;
+  OS_ENTER_CRITICAL();
+  os_size_t left = 0;
+  for (os_tcb_t *task = os_ctx.delayed; task != &bench_tick_probe;
+       task = task->delay_next) {
+    left += task->delay;
+  }
+  left += bench_tick_probe.delay;
+  os_delay_remove(&bench_tick_probe);
+  OS_EXIT_CRITICAL();
+  return BENCH_SLEEPER_DELAY - left;
+}
+
+/**
+ * @brief Checks that long sleeps in tickless idle last as many systicks as
+ * asked for, both by the kernel's count and by the cycle counter. A systick
+ * is the median period of sleeps too short to be suppressed.
+ */
+static void _bench_tickless(void) {
+  static const os_size_t sleeps[] = {2, 10, 100, 1000};
+  char name[32];
+  os_u32_t cycles;
+  os_sleep(1);
+  os_u32_t last = os_port_get_cycles();
+  for (os_size_t i = 0; i < BENCH_SAMPLE_CNT; i++) {
+    os_sleep(1);
+    os_u32_t now = os_port_get_cycles();
+    bench_samples[i] = now - last;
+    last = now;
+  }
+  _report("os_sleep(1) loop period");
+  os_u32_t tick = bench_samples[BENCH_SAMPLE_CNT / 2];
+  printf("%-30s %8s %8s %8s\n", "tickless sleep", "ticks", "cycles",
+         "expected");
+  for (os_size_t i = 0; i < (sizeof(sleeps) / sizeof(sleeps[0])); i++) {
+    os_size_t ticks = _probed_sleep(sleeps[i], &cycles);
+    os_u32_t expected = (os_u32_t)sleeps[i] * tick;
+    /*
+     * The sleep starts within a systick, so it may be one short. A wake-up
+     * that comes late may be charged one more.
+     */
+    os_bool_t ok = ((ticks == sleeps[i]) || (ticks == sleeps[i] + 1)) &&
+                   (cycles + tick >= expected) && (cycles <= expected + tick);
+    snprintf(name, sizeof(name), "os_sleep(%lu)", (unsigned long)sleeps[i]);
+    printf("%-30s %8lu %8lu %8lu %s\n", name, (unsigned long)ticks,
+           (unsigned long)cycles, (unsigned long)expected, ok ? "ok" : "OFF");
+  }
+}
+#endif
+
+void bench_sleeper_entry(void *param) {
+  OS_UNUSED(param);
+  while (1) {
+    os_sleep(BENCH_SLEEPER_DELAY);
+  }
+}
+
+void bench_waiter_entry(void *param) {
+  OS_UNUSED(param);
+  os_u32_t msg;
+  os_u32_t records[BENCH_RING_BATCH];
+  while (1) {
+    os_semaphore_take(OS_SEMAPHORE_ID_BENCH_WAKE, 0);
+    switch (bench_mode) {
+    case BENCH_MODE_MUTEX:
+      os_mutex_take(OS_MUTEX_ID_BENCH, 0);
+      bench_samples[bench_idx] = os_port_get_cycles() - bench_start;
+      os_mutex_give(OS_MUTEX_ID_BENCH);
+      break;
+    case BENCH_MODE_RING:
+      os_ring_wait(OS_RING_ID_BENCH, 0);
+      os_ring_read(OS_RING_ID_BENCH, records, BENCH_RING_BATCH);
+      bench_samples[bench_idx] =
+          (os_port_get_cycles() - bench_start) / BENCH_RING_BATCH;
+      break;
+    case BENCH_MODE_MSGQ:
+      os_msgq_receive(OS_MSGQ_ID_BENCH_1, &msg, 0);
+      bench_samples[bench_idx] = os_port_get_cycles() - bench_start;
+      break;
+    case BENCH_MODE_WAKE:
+      bench_samples[bench_idx] = os_port_get_cycles() - bench_start;
+      break;
+    case BENCH_MODE_NOTIFY:
+      os_task_notify_wait(OS_TRUE, 0, OS_NULL);
+      bench_samples[bench_idx] = os_port_get_cycles() - bench_start;
+      break;
+    case BENCH_MODE_NOTIFY_ISR:
+      os_task_notify_wait(OS_TRUE, 0, OS_NULL);
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+/**
+ * @brief Waits until the contention benchmark lets it in, then takes the mutex
+ * and gives it back, over and over.
+ */
+void bench_contender_entry(void *param) {
+  OS_UNUSED(param);
+  while (1) {
+    os_semaphore_take(OS_SEMAPHORE_ID_BENCH_CONTEND, 0);
+    while (bench_contending) {
+      os_mutex_take(OS_MUTEX_ID_BENCH, 0);
+      os_mutex_give(OS_MUTEX_ID_BENCH);
+    }
+  }
+}
+
+void bench_flags_entry(void *param) {
+  os_flags_t flag = (os_flags_t)(unsigned long)param;
+  while (1) {
+    os_flags_wait(OS_FLAGS_ID_BENCH, flag,
+                  OS_FLAGS_WAIT_ANY | OS_FLAGS_CLEAR_ON_EXIT, 0, OS_NULL);
+    if (++bench_flags_woken == BENCH_FLAGS_WAITER_CNT) {
+      bench_samples[bench_idx] = os_port_get_cycles() - bench_start;
+    }
+  }
+}
+
+void bench_spin_entry(void *param) {
+  volatile os_u32_t *count = &bench_spin_counts[(unsigned long)param];
+  while (1) {
+    os_semaphore_take(OS_SEMAPHORE_ID_BENCH_SPIN, 0);
+    while (!bench_spin_stop) {
+      (*count)++;
+    }
+  }
+}
+
+void bench_timer_callback(void *param) {
+  if (_timer_sample()) {
+    os_timer_stop((os_timer_id_t)(unsigned long)param);
+    os_semaphore_give(OS_SEMAPHORE_ID_BENCH_TIMER_DONE);
+  }
+}
+
+void bench_ticker_entry(void *param) {
+  OS_UNUSED(param);
+  /* it's the first of the highest priority tasks, so it runs first */
+  bench_boot_cycles = os_port_get_cycles() - bench_boot_start;
+  while (1) {
+    os_semaphore_take(OS_SEMAPHORE_ID_BENCH_TICKER, 0);
+    while (!_timer_sample()) {
+      os_sleep(BENCH_TIMER_PERIOD);
+    }
+    os_semaphore_give(OS_SEMAPHORE_ID_BENCH_TIMER_DONE);
+  }
+}
+
+void bench_fpu_entry(void *param) {
+  OS_UNUSED(param);
+  volatile os_f32_t acc = 1.0f;
+#if BENCH_FPU_CHECK
+  os_u32_t clobber[BENCH_FPU_REGS];
+  for (os_size_t i = 0; i < BENCH_FPU_REGS; i++) {
+    clobber[i] = 0xdead0000UL + i;
+  }
+#endif
+  while (1) {
+    os_semaphore_take(OS_SEMAPHORE_ID_BENCH_FPU, 0);
+    if (bench_mode == BENCH_MODE_FPU_CHECK) {
+#if BENCH_FPU_CHECK
+      while (bench_fpu_checking) {
+        _fpu_fill(clobber);
+        bench_fpu_clobbers++;
+        os_sleep(1);
+      }
+#endif
+    } else {
+      bench_samples[bench_idx] = os_port_get_cycles() - bench_start;
+    }
+    /* keeps an FPU context */
+    acc = acc * 1.5f;
+  }
+}
+
+void bench_entry(void *param) {
+  OS_UNUSED(param);
+
+  /* let the sleepers fall asleep and the contenders wait */
+  os_sleep(1);
+
+  _bench_overhead();
+  printf("%-30s %8s %8s %8s %8s %8s %8s\n", "benchmark", "min", "avg", "p50",
+         "p90", "p99", "max");
+#if OS_CFG_ENABLE_TRACE
+  /* first, so that the dumped trace ends with kernel traffic */
+  _bench_trace();
+#endif
+  _bench_critical();
+  _bench_semaphore();
+  _bench_notify();
+  _bench_mutex();
+  _bench_rwlock();
+  _bench_wake();
+  _bench_notify_wake();
+  _bench_wake_fpu();
+  _bench_mutex_handoff();
+  _bench_contention();
+  _bench_priority_lookup();
+  _bench_msgq(OS_MSGQ_ID_BENCH_1, 1, "msgq send+receive depth 1");
+  _bench_msgq(OS_MSGQ_ID_BENCH_4, 4, "msgq send+receive depth 4");
+  _bench_msgq(OS_MSGQ_ID_BENCH_16, 16, "msgq send+receive depth 16");
+  _bench_msgq_handoff();
+  _bench_ring();
+  _bench_ring_batch();
+  _bench_flags_broadcast();
+  _bench_pool();
+  _bench_malloc();
+  _bench_pool_batch();
+  _bench_malloc_batch();
+  _bench_task_spawn();
+  _bench_task_create_delete();
+  _bench_isr();
+  _bench_isr_give();
+  _bench_isr_notify();
+  _bench_isr_post();
+  _bench_isr_post_wake();
+  _bench_systick();
+#if OS_CFG_ENABLE_STATS
+  _bench_stats_snapshot();
+#endif
+  printf("counter overhead: %lu (subtracted)\n", (unsigned long)bench_overhead);
+  printf("os_init() to the first task: %lu, stack fill: %s\n",
+         (unsigned long)bench_boot_cycles,
+         (OS_CFG_STACK_FILL == OS_STACK_FILL_BOOT)   ? "boot"
+         : (OS_CFG_STACK_FILL == OS_STACK_FILL_IDLE) ? "idle"
+                                                     : "none");
+  _bench_timer(OS_TIMER_ID_BENCH_TASK, "timer period 2, service task");
+  _bench_timer(OS_TIMER_ID_BENCH_ISR, "timer period 2, in isr");
+  _bench_ticker();
+  _bench_time_slicing();
+  _bench_readers();
+#if OS_CFG_ENABLE_TICKLESS_IDLE
+  _bench_tickless();
+#endif
+#if BENCH_FPU_CHECK
+  _bench_fpu_check();
+#endif
+#if OS_CFG_ENABLE_STATS
+  _print_task_stats();
+#endif
+#if OS_CFG_ENABLE_TRACE && defined(__unix__)
+  _dump_trace();
+#endif
+#if OS_CFG_ENABLE_CRITICAL_PROFILER
+  os_critical_profile_dump(_print_critical_site);
+#endif
+#if OS_CFG_ENABLE_STACK_GUARD
+  printf("overflowing the stack of task %u\n", (unsigned)os_task_get_id());
+  _overflow_stack(0);
+  printf("stack guard: overflow not caught\n");
+  exit(1);
+#endif
+
+  exit(0);
+}
+
+void os_panic_hook(os_error_t reason) {
+#if OS_CFG_ENABLE_STACK_GUARD
+  if ((reason == OS_STACK_OVERFLOW) && (os_task_get_id() == OS_TASK_ID_BENCH)) {
+    printf("stack guard: overflow of task %u caught\n",
+           (unsigned)os_task_get_id());
+    exit(0);
+  }
+#endif
+  printf("kernel panic: %d\n", reason);
+  exit(1);
+}
+
+void os_task_exit_hook(void) {}
+
+int main(void) {
+#if BENCH_SEMIHOSTING
+  initialise_monitor_handles();
+#endif
+  os_port_cycle_counter_init();
+  bench_boot_start = os_port_get_cycles();
+  os_init();
+  return 0;
+}
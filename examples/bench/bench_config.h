@@ -0,0 +1,170 @@
+#pragma once
+
+#define OS_MUTEX_DEFINITIONS OS_MUTEX(OS_MUTEX_ID_BENCH)
+
+#define OS_SEMAPHORE_DEFINITIONS                                               \
+  OS_SEMAPHORE(OS_SEMAPHORE_ID_BENCH, 0)                                       \
+  OS_SEMAPHORE(OS_SEMAPHORE_ID_BENCH_WAKE, 0)                                  \
+  OS_SEMAPHORE(OS_SEMAPHORE_ID_BENCH_CONTEND, 0)                               \
+  OS_SEMAPHORE(OS_SEMAPHORE_ID_BENCH_FPU, 0)                                   \
+  OS_SEMAPHORE(OS_SEMAPHORE_ID_BENCH_SPIN, 0)                                  \
+  OS_SEMAPHORE(OS_SEMAPHORE_ID_BENCH_TICKER, 0)                                \
+  OS_SEMAPHORE(OS_SEMAPHORE_ID_BENCH_TIMER_DONE, 0)
+
+/**
+ * @brief   The contenders wait for the mutex in the contention benchmark. There
+ *          are 64 of them, or 8 on boards short of RAM.
+ */
+#ifndef BENCH_CONTENDER_CNT
+#define BENCH_CONTENDER_CNT 64U
+#endif
+
+#define BENCH_CONTENDER(_n)                                                    \
+  OS_TASK(OS_TASK_ID_BENCH_CONTENDER_##_n, 1, 256, bench_contender_entry,      \
+          OS_NULL, 0)
+#define BENCH_CONTENDERS_8(_n)                                                 \
+  BENCH_CONTENDER(_n##0)                                                       \
+  BENCH_CONTENDER(_n##1)                                                       \
+  BENCH_CONTENDER(_n##2)                                                       \
+  BENCH_CONTENDER(_n##3)                                                       \
+  BENCH_CONTENDER(_n##4)                                                       \
+  BENCH_CONTENDER(_n##5)                                                       \
+  BENCH_CONTENDER(_n##6)                                                       \
+  BENCH_CONTENDER(_n##7)
+
+#if BENCH_CONTENDER_CNT == 64U
+#define BENCH_CONTENDERS                                                       \
+  BENCH_CONTENDERS_8(0)                                                        \
+  BENCH_CONTENDERS_8(1)                                                        \
+  BENCH_CONTENDERS_8(2)                                                        \
+  BENCH_CONTENDERS_8(3)                                                        \
+  BENCH_CONTENDERS_8(4)                                                        \
+  BENCH_CONTENDERS_8(5)                                                        \
+  BENCH_CONTENDERS_8(6)                                                        \
+  BENCH_CONTENDERS_8(7)
+#elif BENCH_CONTENDER_CNT == 8U
+#define BENCH_CONTENDERS BENCH_CONTENDERS_8(0)
+#else
+#error BENCH_CONTENDER_CNT needs to be either 64U or 8U!
+#endif
+
+/**
+ * @brief   The ticker and the timer service task run at the top priority,
+ *          which sets the amount of priority levels. A top priority of 32 or
+ *          more makes the kernel use the two-level priority bitmap.
+ */
+#ifndef BENCH_TOP_PRIORITY
+#define BENCH_TOP_PRIORITY 4U
+#endif
+
+#define OS_MSGQ_DEFINITIONS                                                    \
+  OS_MSGQ(OS_MSGQ_ID_BENCH_1, 4, 1)                                            \
+  OS_MSGQ(OS_MSGQ_ID_BENCH_4, 4, 4)                                            \
+  OS_MSGQ(OS_MSGQ_ID_BENCH_16, 4, 16)
+
+#define OS_RING_DEFINITIONS OS_RING(OS_RING_ID_BENCH, 4, 16, 16)
+
+#define OS_FLAGS_DEFINITIONS OS_FLAGS(OS_FLAGS_ID_BENCH, 0)
+
+#define OS_POOL_DEFINITIONS OS_POOL(OS_POOL_ID_BENCH, 64, 16)
+
+#define OS_RWLOCK_DEFINITIONS OS_RWLOCK(OS_RWLOCK_ID_BENCH)
+
+#define OS_TIMER_DEFINITIONS                                                   \
+  OS_TIMER(OS_TIMER_ID_BENCH_TASK, 2, OS_TIMER_PERIODIC, bench_timer_callback, \
+           (void *)OS_TIMER_ID_BENCH_TASK)                                     \
+  OS_TIMER(OS_TIMER_ID_BENCH_ISR, 2, OS_TIMER_PERIODIC | OS_TIMER_IN_ISR,      \
+           bench_timer_callback, (void *)OS_TIMER_ID_BENCH_ISR)
+
+/**
+ * @brief   Sleepers only populate the delayed list for the systick benchmark.
+ *          The contenders run below the bench task, so they only get the
+ *          mutex when it blocks. The waiters preempt the bench task as soon
+ *          as they're woken up. The spinners share a priority level and a
+ *          slice of twice the default length makes the last one get half of
+ *          the CPU. The ticker does a periodic job the way it's done without
+ *          timers.
+ */
+#define OS_TASK_DEFINITIONS                                                    \
+  OS_TASK(OS_TASK_ID_IDLE, 0, 512, idle_entry, OS_NULL, 0)                     \
+  OS_TASK(OS_TASK_ID_BENCH_SLEEPER_0, 1, 256, bench_sleeper_entry, OS_NULL, 0) \
+  OS_TASK(OS_TASK_ID_BENCH_SLEEPER_1, 1, 256, bench_sleeper_entry, OS_NULL, 0) \
+  OS_TASK(OS_TASK_ID_BENCH_SLEEPER_2, 1, 256, bench_sleeper_entry, OS_NULL, 0) \
+  OS_TASK(OS_TASK_ID_BENCH_SLEEPER_3, 1, 256, bench_sleeper_entry, OS_NULL, 0) \
+  OS_TASK(OS_TASK_ID_BENCH_SPIN_0, 1, 256, bench_spin_entry, (void *)0, 0)     \
+  OS_TASK(OS_TASK_ID_BENCH_SPIN_1, 1, 256, bench_spin_entry, (void *)1, 0)     \
+  OS_TASK(OS_TASK_ID_BENCH_SPIN_2, 1, 256, bench_spin_entry, (void *)2, 10)    \
+  BENCH_CONTENDERS                                                             \
+  OS_TASK(OS_TASK_ID_BENCH, 2, 2048, bench_entry, OS_NULL, 0)                  \
+  OS_TASK(OS_TASK_ID_BENCH_WAITER, 3, 1024, bench_waiter_entry, OS_NULL, 0)    \
+  OS_TASK(OS_TASK_ID_BENCH_FPU, 3, 1024, bench_fpu_entry, OS_NULL, 0)          \
+  OS_TASK(OS_TASK_ID_BENCH_FLAGS_0, 3, 512, bench_flags_entry, (void *)0x1, 0) \
+  OS_TASK(OS_TASK_ID_BENCH_FLAGS_1, 3, 512, bench_flags_entry, (void *)0x2, 0) \
+  OS_TASK(OS_TASK_ID_BENCH_FLAGS_2, 3, 512, bench_flags_entry, (void *)0x4, 0) \
+  OS_TASK(OS_TASK_ID_BENCH_FLAGS_3, 3, 512, bench_flags_entry, (void *)0x8, 0) \
+  OS_TASK(OS_TASK_ID_BENCH_TICKER, BENCH_TOP_PRIORITY, 512,                    \
+          bench_ticker_entry, OS_NULL, 0)                                      \
+  OS_TASK(OS_TASK_ID_TIMER, BENCH_TOP_PRIORITY, 512, timer_entry, OS_NULL, 0)
+
+#ifndef BENCH_STATS
+#define BENCH_STATS 0U
+#endif
+
+#define OS_CFG_ENABLE_STATS BENCH_STATS
+#define OS_CFG_ENABLE_MESSAGE_QUEUES 1U
+#define OS_CFG_ENABLE_MUTEXES 1U
+#define OS_CFG_ENABLE_SEMAPHORES 1U
+
+#ifndef BENCH_TICKLESS
+#define BENCH_TICKLESS 0U
+#endif
+
+#define OS_CFG_ENABLE_TICKLESS_IDLE BENCH_TICKLESS
+#define OS_CFG_ENABLE_RING_BUFFERS 1U
+#define OS_CFG_ENABLE_EVENT_FLAGS 1U
+#define OS_CFG_ENABLE_ISR_POSTS 1U
+#define OS_CFG_ISR_POST_QUEUE_DEPTH 16U
+#define OS_CFG_ENABLE_MEMORY_POOLS 1U
+
+#ifndef BENCH_TRACE
+#define BENCH_TRACE 0U
+#endif
+
+#define OS_CFG_ENABLE_TRACE BENCH_TRACE
+#define OS_CFG_TRACE_BUFFER_DEPTH 1024U
+#define OS_CFG_ENABLE_TIME_SLICING 1U
+#define OS_CFG_TIME_SLICE_QUANTUM 5U
+#define OS_CFG_ENABLE_TIMERS 1U
+
+#ifndef BENCH_STACK_FILL
+#define BENCH_STACK_FILL OS_STACK_FILL_BOOT
+#endif
+
+#define OS_CFG_STACK_FILL BENCH_STACK_FILL
+#define OS_CFG_ENABLE_TASK_NOTIFICATIONS 1U
+
+#ifndef BENCH_CRITICAL
+#define BENCH_CRITICAL 0U
+#endif
+
+#define OS_CFG_ENABLE_CRITICAL_PROFILER BENCH_CRITICAL
+
+#ifndef BENCH_STACK_GUARD
+#define BENCH_STACK_GUARD 0U
+#endif
+
+#define OS_CFG_ENABLE_STACK_GUARD BENCH_STACK_GUARD
+
+/**
+ * @brief   The pool tasks are the readers of the rwlock benchmark, so it runs
+ *          with up to this many readers.
+ */
+#ifndef BENCH_DYNAMIC_TASK_CNT
+#define BENCH_DYNAMIC_TASK_CNT 16U
+#endif
+
+#define OS_CFG_ENABLE_DYNAMIC_TASKS 1U
+#define OS_CFG_DYNAMIC_TASK_CNT BENCH_DYNAMIC_TASK_CNT
+#define OS_CFG_DYNAMIC_TASK_STACK_SIZE 512U
+#define OS_CFG_ENABLE_RWLOCKS 1U
+#define OS_CFG_RWLOCK_READER_CNT BENCH_DYNAMIC_TASK_CNT
@@ -0,0 +1,77 @@
+/*
+ * Minimal startup for the LM3S6965 (QEMU lm3s6965evb), used to run the
+ * benchmarks without any vendor code.
+ */
+#include "seal.h"
+
+#define BENCH_SYSTICK_HZ 1000UL
+#define BENCH_CPU_HZ 12000000UL
+
+#define BENCH_SHPR3_SYSTICK_REG *((volatile os_u8_t *)0xe000ed23)
+#define BENCH_SYSTICK_CTRL_REG *((volatile os_reg_t *)0xe000e010)
+#define BENCH_SYSTICK_LOAD_REG *((volatile os_reg_t *)0xe000e014)
+#define BENCH_SYSTICK_VAL_REG *((volatile os_reg_t *)0xe000e018)
+
+/* SysTick needs to be masked by BASEPRI */
+#define BENCH_SYSTICK_PRIO 0xc0U
+/* core clock, interrupt enabled, counter enabled */
+#define BENCH_SYSTICK_CTRL_VAL 0x07UL
+
+extern os_u32_t _sidata;
+extern os_u32_t _sdata;
+extern os_u32_t _edata;
+extern os_u32_t _sbss;
+extern os_u32_t _ebss;
+extern os_u32_t _estack;
+
+int main(void);
+void bench_reset_handler(void);
+void bench_default_handler(void);
+
+void bench_reset_handler(void) {
+  os_u32_t *src = &_sidata;
+  for (os_u32_t *dst = &_sdata; dst < &_edata; dst++) {
+    *dst = *src++;
+  }
+  for (os_u32_t *dst = &_sbss; dst < &_ebss; dst++) {
+    *dst = 0;
+  }
+
+  BENCH_SHPR3_SYSTICK_REG = BENCH_SYSTICK_PRIO;
+  BENCH_SYSTICK_LOAD_REG = (BENCH_CPU_HZ / BENCH_SYSTICK_HZ) - 1;
+  BENCH_SYSTICK_VAL_REG = 0;
+  BENCH_SYSTICK_CTRL_REG = BENCH_SYSTICK_CTRL_VAL;
+
+  main();
+  while (1) {
+  }
+}
+
+void bench_default_handler(void) {
+  while (1) {
+  }
+}
+
+__attribute__((section(".isr_vector"), used)) static const os_u32_t
+    bench_vectors[] = {
+        (os_u32_t)&_estack,
+        (os_u32_t)bench_reset_handler,
+        (os_u32_t)bench_default_handler, /* NMI */
+        (os_u32_t)bench_default_handler, /* HardFault */
+#if OS_CFG_ENABLE_STACK_GUARD
+        (os_u32_t)os_port_memmanage_handler,
+#else
+        (os_u32_t)bench_default_handler, /* MemManage */
+#endif
+        (os_u32_t)bench_default_handler, /* BusFault */
+        (os_u32_t)bench_default_handler, /* UsageFault */
+        0,
+        0,
+        0,
+        0,
+        (os_u32_t)bench_default_handler, /* SVCall */
+        (os_u32_t)bench_default_handler, /* DebugMon */
+        0,
+        (os_u32_t)os_port_pendsv_handler,
+        (os_u32_t)os_port_systick_handler,
+};
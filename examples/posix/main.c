@@ -0,0 +1,55 @@
+#include "seal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+void led_entry(void *param) {
+  OS_UNUSED(param);
+
+  os_semaphore_take(OS_SEMAPHORE_ID_FOO, 100);
+
+  os_mutex_take(OS_MUTEX_ID_FOO, 100);
+
+  while (1) {
+    printf("led\n");
+    os_sleep(250);
+  }
+}
+
+void print_entry(void *param) {
+  OS_UNUSED(param);
+
+  os_sleep(2000);
+
+  if (os_semaphore_take(OS_SEMAPHORE_ID_FOO, 2000) == OS_TIMEOUT) {
+    while (1) {
+      printf("semaphore timeout\n");
+      os_sleep(250);
+    }
+  }
+
+  if (os_mutex_take(OS_MUTEX_ID_FOO, 2000) == OS_TIMEOUT) {
+    while (1) {
+      printf("mutex timeout\n");
+      os_sleep(250);
+    }
+  }
+
+  while (1) {
+    printf("foobar\n");
+    os_sleep(250);
+  }
+}
+
+void os_panic_hook(os_error_t reason) {
+  fprintf(stderr, "kernel panic: %d\n", reason);
+  abort();
+}
+
+void os_task_exit_hook(void) {}
+
+int main(void) {
+  setvbuf(stdout, OS_NULL, _IONBF, 0);
+  os_init();
+  return 0;
+}
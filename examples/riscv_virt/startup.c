@@ -0,0 +1,59 @@
+/*
+ * Minimal startup for the QEMU virt machine (RV32), used to run the example
+ * tasks and the benchmarks without any vendor code. stdout goes to the 16550
+ * UART and exit() powers QEMU off through the test device.
+ *
+ *   qemu-system-riscv32 -M virt -bios none -nographic -kernel seal.elf
+ */
+#include "seal.h"
+
+#define VIRT_UART_THR_REG *((volatile os_u8_t *)0x10000000UL)
+#define VIRT_UART_LSR_REG *((volatile os_u8_t *)0x10000005UL)
+#define VIRT_UART_LSR_THRE_BIT (1U << 5U)
+
+#define VIRT_TEST_REG *((volatile os_u32_t *)0x00100000UL)
+#define VIRT_TEST_PASS_VAL 0x5555UL
+#define VIRT_TEST_FAIL_VAL 0x3333UL
+
+extern os_u32_t _sbss;
+extern os_u32_t _ebss;
+
+int main(void);
+void virt_reset_handler(void);
+void virt_start(void);
+int _write(int fd, const char *buf, int len);
+void _exit(int code);
+
+__attribute__((naked, section(".text.init"))) void virt_reset_handler(void) {
+  __asm volatile(".option push             \n"
+                 ".option norelax          \n"
+                 "la gp, __global_pointer$ \n"
+                 ".option pop              \n"
+                 "la sp, _estack           \n"
+                 "j virt_start             \n");
+}
+
+void virt_start(void) {
+  for (os_u32_t *dst = &_sbss; dst < &_ebss; dst++) {
+    *dst = 0;
+  }
+
+  _exit(main());
+}
+
+int _write(int fd, const char *buf, int len) {
+  OS_UNUSED(fd);
+  for (int i = 0; i < len; i++) {
+    while (!(VIRT_UART_LSR_REG & VIRT_UART_LSR_THRE_BIT)) {
+    }
+    VIRT_UART_THR_REG = (os_u8_t)buf[i];
+  }
+  return len;
+}
+
+void _exit(int code) {
+  VIRT_TEST_REG = (code == 0) ? VIRT_TEST_PASS_VAL
+                              : (((os_u32_t)code << 16) | VIRT_TEST_FAIL_VAL);
+  while (1) {
+  }
+}
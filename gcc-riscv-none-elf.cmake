@@ -0,0 +1,24 @@
+set(CMAKE_SYSTEM_NAME Generic)
+set(CMAKE_SYSTEM_PROCESSOR riscv32)
+set(CMAKE_CROSSCOMPILING 1)
+
+# riscv-none-elf- is the xPack prefix, distro toolchains often use
+# riscv64-unknown-elf-, which builds rv32 just as well
+if(NOT TOOLCHAIN_PREFIX)
+    set(TOOLCHAIN_PREFIX riscv-none-elf-)
+endif()
+set(FLAGS
+    "-fdata-sections -ffunction-sections \
+    --specs=nano.specs -Wl,--gc-sections")
+
+set(CMAKE_C_COMPILER ${TOOLCHAIN_PREFIX}gcc ${FLAGS})
+set(CMAKE_ASM_COMPILER ${CMAKE_C_COMPILER})
+set(CMAKE_OBJCOPY ${TOOLCHAIN_PREFIX}objcopy)
+set(CMAKE_SIZE ${TOOLCHAIN_PREFIX}size)
+
+set(CMAKE_C_COMPILER_WORKS 1)
+
+set(CMAKE_EXECUTABLE_SUFFIX_ASM ".elf")
+set(CMAKE_EXECUTABLE_SUFFIX_C ".elf")
+
+set(CMAKE_TRY_COMPILE_TARGET_TYPE STATIC_LIBRARY)
@@ -3,36 +3,388 @@
 os_tcb_t *volatile os_curr_task = OS_NULL;
 os_tcb_t *volatile os_next_task = OS_NULL;
 
-#define OS_TASK(_id, _priority, _stack_size, _entry_func, _entry_func_param)   \
-  static os_stack_t os_stack_##_id[OS_PORT_BYTES_TO_SECTORS(_stack_size)];
+#define OS_TASK(_id, _priority, _stack_size, _entry_func, _entry_func_param,   \
+                _quantum)                                                      \
+  static os_stack_t os_stack_##_id[OS_STACK_GUARD_WORDS +                     \
+                                   OS_PORT_BYTES_TO_SECTORS(_stack_size)]     \
+      OS_STACK_GUARD_ALIGNED;
 OS_TASK_DEFINITIONS
 #undef OS_TASK
 
+#if OS_CFG_ENABLE_TIME_SLICING
+#define OS_TASK_DESC_QUANTUM(_quantum)                                         \
+  .quantum = ((_quantum) != 0) ? (_quantum) : OS_CFG_TIME_SLICE_QUANTUM,
+#else
+#define OS_TASK_DESC_QUANTUM(_quantum)
+#endif
+
+/**
+ * @brief Task descriptors, os_init() builds the TCBs from them.
+ */
+static const os_task_desc_t os_task_descs[OS_TASK_ID_CNT] = {
+#define OS_TASK(_id, _priority, _stack_size, _entry_func, _entry_func_param,   \
+                _quantum)                                                      \
+  [_id] = {.stack = &os_stack_##_id[OS_STACK_GUARD_WORDS],                    \
+           .stack_size = OS_PORT_BYTES_TO_SECTORS(_stack_size),                \
+           .entry_func = _entry_func,                                          \
+           .entry_func_param = _entry_func_param,                              \
+           OS_TASK_DESC_QUANTUM(_quantum).priority = _priority},
+    OS_TASK_DEFINITIONS
+#undef OS_TASK
+};
+
+#if OS_CFG_ENABLE_DYNAMIC_TASKS
+/**
+ * @brief Stack of a task pool slot.
+ */
+typedef struct OS_STACK_GUARD_ALIGNED {
+  os_stack_t words[OS_STACK_GUARD_WORDS +
+                   OS_PORT_BYTES_TO_SECTORS(OS_CFG_DYNAMIC_TASK_STACK_SIZE)];
+} os_task_pool_stack_t;
+
+static os_task_pool_stack_t os_task_pool_stacks[OS_CFG_DYNAMIC_TASK_CNT];
+#endif
+
+#if OS_CFG_ENABLE_DYNAMIC_TASKS || OS_CFG_ENABLE_STACK_GUARD
+/**
+ * @brief   Gets the beginning of the stack of a task, above the stack guard.
+ */
+static os_stack_t *_task_stack(os_task_id_t id) {
+#if OS_CFG_ENABLE_DYNAMIC_TASKS
+  if (id >= OS_TASK_ID_CNT) {
+    return &os_task_pool_stacks[id - OS_TASK_ID_CNT]
+                .words[OS_STACK_GUARD_WORDS];
+  }
+#endif
+  return os_task_descs[id].stack;
+}
+#endif
+
+/**
+ * @brief Initial flat ready bitmap, i.e. the priority of every task. The
+ * two-level form is built by _init_tcb().
+ */
+#define OS_TASK(_id, _priority, _stack_size, _entry_func, _entry_func_param,   \
+                _quantum)                                                      \
+  | (1UL << ((_priority) % OS_PRIORITY_GROUP_SIZE))
+static const os_u32_t os_ready_priorities_flat = 0UL OS_TASK_DEFINITIONS;
+#undef OS_TASK
+
+/**
+ * @brief Initial state of the events that need no buffer, the others are set
+ * up by their init functions.
+ */
+static const os_event_desc_t os_event_descs[OS_EVENT_ID_CNT] = {
+#define OS_MUTEX(_id) [_id] = {OS_EVENT_MUTEX, 0},
+    OS_MUTEX_DEFINITIONS
+#undef OS_MUTEX
+#define OS_SEMAPHORE(_id, _count) [_id] = {OS_EVENT_SEMAPHORE, _count},
+        OS_SEMAPHORE_DEFINITIONS
+#undef OS_SEMAPHORE
+#if OS_CFG_ENABLE_EVENT_FLAGS
+#define OS_FLAGS(_id, _initial) [_id] = {OS_EVENT_FLAGS, _initial},
+            OS_FLAGS_DEFINITIONS
+#undef OS_FLAGS
+#endif
+#if OS_CFG_ENABLE_RWLOCKS
+#define OS_RWLOCK(_id) [_id] = {OS_EVENT_RWLOCK, 0},
+                OS_RWLOCK_DEFINITIONS
+#undef OS_RWLOCK
+#endif
+};
+
+#if OS_CFG_ENABLE_MESSAGE_QUEUES
+#define OS_MSGQ(_id, _msg_size, _depth)                                        \
+  static os_u8_t os_msgq_buffer_##_id[(_msg_size) * (_depth)];
+OS_MSGQ_DEFINITIONS
+#undef OS_MSGQ
+#endif
+
+#if OS_CFG_ENABLE_RING_BUFFERS
+#define OS_RING(_id, _record_size, _depth, _wake_level)                        \
+  typedef char os_ring_depth_check_##_id[((_depth) & ((_depth)-1)) ? -1 : 1];  \
+  static os_u8_t os_ring_buffer_##_id[(_record_size) * (_depth)];
+OS_RING_DEFINITIONS
+#undef OS_RING
+#endif
+
+#if OS_CFG_ENABLE_MEMORY_POOLS
+#define OS_POOL(_id, _block_size, _block_cnt)                                  \
+  static void *os_pool_buffer_##_id[OS_POOL_BLOCK_WORDS(_block_size) *         \
+                                    (_block_cnt)];
+OS_POOL_DEFINITIONS
+#undef OS_POOL
+#endif
+
+#if OS_CFG_ENABLE_RWLOCKS
+#define OS_RWLOCK(_id) static os_rwlock_t os_rwlock_##_id;
+OS_RWLOCK_DEFINITIONS
+#undef OS_RWLOCK
+#endif
+
 os_ctx_t os_ctx = {0};
 
+#if OS_CFG_STACK_FILL != OS_STACK_FILL_NONE
+#define OS_STACK_FILL_PATTERN 0xdeadbeefUL
+
+/**
+ * @brief   Fills the words from @p ptr up to, but excluding, @p end with the
+ *          stack fill pattern.
+ */
+static void _stack_fill(os_stack_t *ptr, const os_stack_t *end) {
+  while (ptr < end) {
+    *ptr++ = OS_STACK_FILL_PATTERN;
+  }
+}
+#endif
+
+#if OS_CFG_ENABLE_STATS
+/**
+ * @brief   Places the stack high-water mark at the lowest word of the frame
+ *          built by os_port_init_stack(), i.e. the first word above the fill.
+ *          Ports that keep their own data at the bottom of the stack fill
+ *          only above it, so that part is skipped first.
+ */
+static void _stats_init_hwm(os_tcb_t *task) {
+  os_stack_t *ptr = task->stack_end - (task->stack_size - 1);
+  while ((ptr < task->stack_end) && (*ptr != OS_STACK_FILL_PATTERN)) {
+    ptr++;
+  }
+  while ((ptr < task->stack_end) && (*ptr == OS_STACK_FILL_PATTERN)) {
+    ptr++;
+  }
+  task->stack_hwm = ptr;
+}
+
+/**
+ * @brief   Moves the stack high-water mark of a task down to its stack pointer
+ *          and then past any words that no longer hold the fill pattern.
+ *          Usually it's a single compare.
+ * @param   sp - stack pointer of the task, ignored if it's OS_NULL or outside
+ *          of the stack
+ */
+static void _stats_update_hwm(os_tcb_t *task, os_stack_t *sp) {
+  os_stack_t *base = task->stack_end - (task->stack_size - 1);
+  if ((sp >= base) && (sp < task->stack_hwm)) {
+    task->stack_hwm = sp;
+  }
+  while ((task->stack_hwm > base) &&
+         (task->stack_hwm[-1] != OS_STACK_FILL_PATTERN)) {
+    task->stack_hwm--;
+  }
+}
+
+/**
+ * @brief   Charges the time since the previous switch, the switch and the
+ *          stack usage to a task that's being switched out.
+ */
+static void _stats_switch(os_tcb_t *task, os_stack_t *sp) {
+  os_u32_t now = os_port_get_cycles();
+  task->cycles += now - os_ctx.stats_switch_time;
+  os_ctx.stats_switch_time = now;
+  if (task->state == OS_TASK_READY) {
+    task->involuntary_switches++;
+  } else {
+    task->voluntary_switches++;
+  }
+  _stats_update_hwm(task, sp);
+}
+
+os_error_t os_task_stats_snapshot(os_task_stats_t *stats) {
+  OS_DECLARE_CRITICAL();
+  if (stats == OS_NULL) {
+    return OS_NULL_PARAM;
+  }
+  OS_ENTER_CRITICAL();
+  /* the running task is accounted up to now */
+  os_u32_t now = os_port_get_cycles();
+  os_curr_task->cycles += now - os_ctx.stats_switch_time;
+  os_ctx.stats_switch_time = now;
+  _stats_update_hwm(os_curr_task, (os_stack_t *)__builtin_frame_address(0));
+  for (os_size_t i = 0; i < OS_TASK_SLOT_CNT; i++) {
+    os_tcb_t *task = &os_ctx.tcbs[i];
+    if (task->state == OS_TASK_DELETED) {
+      stats[i] = (os_task_stats_t){0};
+      continue;
+    }
+    stats[i].cycles = task->cycles;
+    stats[i].voluntary_switches = task->voluntary_switches;
+    stats[i].involuntary_switches = task->involuntary_switches;
+    stats[i].stack_size = task->stack_size * sizeof(os_stack_t);
+    stats[i].stack_used_max =
+        (os_size_t)(task->stack_end - task->stack_hwm + 1) * sizeof(os_stack_t);
+  }
+  OS_EXIT_CRITICAL();
+  return OS_OK;
+}
+#endif /* if OS_CFG_ENABLE_STATS */
+
+#if OS_CFG_ENABLE_CRITICAL_PROFILER
+void os_critical_profile_enter(os_critical_site_t *site) {
+  if (os_ctx.critical_depth++ == 0) {
+    os_ctx.critical_site = site;
+    os_ctx.critical_start = os_port_get_cycles();
+  }
+}
+
+void os_critical_profile_exit(void) {
+  if (--os_ctx.critical_depth != 0) {
+    return;
+  }
+  os_critical_site_t *site = os_ctx.critical_site;
+  os_u32_t cycles = os_port_get_cycles() - os_ctx.critical_start;
+  site->count++;
+  site->total += cycles;
+  if (cycles > site->max) {
+    site->max = cycles;
+  }
+  if (!site->linked) {
+    site->linked = OS_TRUE;
+    site->next = os_ctx.critical_sites;
+    os_ctx.critical_sites = site;
+  }
+}
+
+/*
+ * The sites are accessed with the port functions, so that the profiler
+ * doesn't record itself.
+ */
+void os_critical_profile_dump(os_critical_dump_func_t func) {
+  os_reg_t critical = os_port_enter_critical();
+  os_critical_site_t *site = os_ctx.critical_sites;
+  os_port_exit_critical(critical);
+  while (site != OS_NULL) {
+    critical = os_port_enter_critical();
+    os_critical_site_t copy = *site;
+    os_port_exit_critical(critical);
+    func(&copy);
+    site = copy.next;
+  }
+}
+
+void os_critical_profile_reset(void) {
+  os_reg_t critical = os_port_enter_critical();
+  for (os_critical_site_t *site = os_ctx.critical_sites; site != OS_NULL;
+       site = site->next) {
+    site->count = 0;
+    site->max = 0;
+    site->total = 0;
+  }
+  os_port_exit_critical(critical);
+}
+#endif /* if OS_CFG_ENABLE_CRITICAL_PROFILER */
+
+#if OS_CFG_ENABLE_TRACE
+os_trace_buffer_t os_trace_buffer = {
+    .magic = OS_TRACE_MAGIC,
+    .depth = OS_CFG_TRACE_BUFFER_DEPTH,
+    .record_size = sizeof(os_trace_record_t),
+};
+#endif
+
+#if OS_CFG_ENABLE_STACK_GUARD
+/**
+ * @brief Moves the stack guard to the words right below the stack of @p task.
+ */
+static void _stack_guard(const os_tcb_t *task) {
+  os_port_stack_guard(_task_stack(task->tid) - OS_STACK_GUARD_WORDS);
+}
+#endif
+
+#if OS_SWITCH_HOOK
+void os_switch_hook(os_stack_t *sp) {
+  if (os_curr_task == os_next_task) {
+    return;
+  }
+  OS_TRACE(OS_TRACE_SWITCH, os_next_task->tid);
+#if OS_CFG_ENABLE_STACK_GUARD
+  _stack_guard(os_next_task);
+#endif
+#if OS_CFG_ENABLE_STATS
+  _stats_switch(os_curr_task, sp);
+#else
+  OS_UNUSED(sp);
+#endif
+}
+#endif
+
 /**
- * @brief   Initializes a single task control block.
- * @param id
- * @param base_prio
- * @param stack_size
+ * @brief   Initializes a single task control block from its descriptor.
  */
-static void _init_tcb(os_size_t id, os_u8_t base_prio, os_stack_t stack_size,
-                      os_stack_t *stack_base, os_task_func_t entry_func,
-                      void *entry_func_param) {
-  os_ctx.tcbs[id].tid = id;
-  os_ctx.tcbs[id].base_prio = base_prio;
-  os_ctx.tcbs[id].curr_prio = base_prio;
-  os_ctx.tcbs[id].stack_ptr =
-      os_port_init_stack(entry_func, stack_base, stack_size, entry_func_param);
+static void _init_tcb(os_size_t id, const os_task_desc_t *desc) {
+  os_tcb_t *task = &os_ctx.tcbs[id];
+  task->tid = id;
+  task->base_prio = desc->priority;
+  task->curr_prio = desc->priority;
+#if OS_CFG_STACK_FILL == OS_STACK_FILL_BOOT
+  _stack_fill(desc->stack, &desc->stack[desc->stack_size]);
+#elif OS_CFG_STACK_FILL == OS_STACK_FILL_IDLE
+  /* the idle task can't fill its own stack, nor the ones of the task pool */
+  if ((desc->priority == 0) || (id >= OS_TASK_ID_CNT)) {
+    _stack_fill(desc->stack, &desc->stack[desc->stack_size]);
+  }
+#endif
+  task->stack_ptr =
+      os_port_init_stack(desc->entry_func, desc->stack, desc->stack_size,
+                         desc->entry_func_param);
 #if OS_CFG_ENABLE_STATS
-  os_ctx.tcbs[id].stack_size = stack_size;
-  os_ctx.tcbs[id].stack_end = &stack_base[stack_size - 1];
+  task->stack_size = desc->stack_size;
+  task->stack_end = &desc->stack[desc->stack_size - 1];
+  _stats_init_hwm(task);
 #endif /* if OS_CFG_ENABLE_STATS */
-  os_queue_push(&os_ctx.tcbs[id], &os_ctx.priorities[base_prio]);
-  OS_PRIORITY_READY(base_prio);
-  os_ctx.tcbs[id].state = OS_TASK_READY;
+#if OS_CFG_ENABLE_TIME_SLICING
+  task->quantum = desc->quantum;
+  task->slice_left = desc->quantum;
+#endif
+}
+
+/**
+ * @brief Makes a task set up by _init_tcb() ready.
+ */
+static void _start_tcb(os_tcb_t *task) {
+  os_queue_push(task, &os_ctx.priorities[task->base_prio]);
+  if (!OS_PRIORITY_IS_FLAT || os_ctx.is_running) {
+    OS_PRIORITY_READY(task->base_prio);
+  }
+  task->state = OS_TASK_READY;
 }
 
+#if OS_CFG_STACK_FILL == OS_STACK_FILL_IDLE
+/**
+ * @brief Amount of words filled per critical section by os_stack_fill().
+ */
+#define OS_STACK_FILL_CHUNK 32U
+
+void os_stack_fill(void) {
+  OS_DECLARE_CRITICAL();
+  for (os_size_t id = 0; id < OS_TASK_ID_CNT; id++) {
+    os_tcb_t *task = &os_ctx.tcbs[id];
+    os_stack_t *ptr = os_task_descs[id].stack;
+    os_bool_t done = (task == os_curr_task);
+    while (!done) {
+      OS_ENTER_CRITICAL();
+      /* the task may have run since the previous chunk */
+      os_stack_t *bottom = os_task_descs[id].stack;
+      os_stack_t *end = os_port_stack_free(task, &bottom);
+      if (ptr < bottom) {
+        ptr = bottom;
+      }
+      os_stack_t *chunk_end = ptr + OS_STACK_FILL_CHUNK;
+      _stack_fill(ptr, (chunk_end < end) ? chunk_end : end);
+      ptr = chunk_end;
+      if (ptr >= end) {
+        done = OS_TRUE;
+#if OS_CFG_ENABLE_STATS
+        /* the usage before the fill is lost, it's measured from now on */
+        task->stack_hwm = end;
+#endif
+      }
+      OS_EXIT_CRITICAL();
+    }
+  }
+}
+#endif /* if OS_CFG_STACK_FILL == OS_STACK_FILL_IDLE */
+
 /**
  * @brief Sets @c os_next_task to point at the first ready task with the
  * highest priority.
@@ -40,12 +392,13 @@ static void _init_tcb(os_size_t id, os_u8_t base_prio, os_stack_t stack_size,
  * @return OS_TRUE - a context switch is needed; OS_FALSE - no context switch
  * is needed
  */
-os_bool_t _set_next_task(void) {
+static os_bool_t _set_next_task(void) {
   if (os_ctx.isr_nesting_cnt == 0) {
-    os_u8_t highest_priority = OS_GET_HIGHEST_PRIORITY(os_ctx.ready_priorities);
+    os_u8_t highest_priority = OS_BITMAP_GET_HIGHEST(os_ctx.ready_priorities);
 
     if (os_ctx.priorities[highest_priority].first != os_next_task) {
       os_next_task = os_ctx.priorities[highest_priority].first;
+      OS_TRACE(OS_TRACE_SCHEDULE, os_next_task->tid);
 
       return OS_TRUE;
     }
@@ -63,6 +416,10 @@ void os_panic(os_error_t reason) {
 
 void os_task_exit(void) {
   os_task_exit_hook();
+#if OS_CFG_ENABLE_DYNAMIC_TASKS
+  os_task_delete(os_curr_task->tid);
+  /* only priority 0 tasks get here */
+#endif
   os_panic(OS_TASK_EXITED);
 }
 
@@ -75,32 +432,171 @@ void os_schedule(void) {
   OS_EXIT_CRITICAL();
 }
 
+/**
+ * @brief   Wakes up all delayed tasks at the head of the delayed list whose
+ *          timeout has expired.
+ * @note    Call this from within a critical section.
+ */
+static void _wake_expired(void) {
+  while ((os_ctx.delayed != OS_NULL) && (os_ctx.delayed->delay == 0)) {
+    os_tcb_t *task = os_ctx.delayed;
+    os_delay_remove(task);
+    switch (task->state) {
+    case OS_TASK_WAITING_FOR_EVENT:
+      os_event_timeout(task);
+      break;
+#if OS_CFG_ENABLE_TASK_NOTIFICATIONS
+    case OS_TASK_WAITING_FOR_NOTIFICATION:
+      OS_TRACE(OS_TRACE_TIMEOUT, task->tid);
+      task->wait_return = OS_WAIT_RET_TIMEOUT;
+      break;
+#endif
+    case OS_TASK_ASLEEP:
+      break;
+    default:
+      os_panic(OS_ERROR);
+    }
+    os_queue_push(task, &os_ctx.priorities[task->curr_prio]);
+    OS_PRIORITY_READY(task->curr_prio);
+    task->state = OS_TASK_READY;
+  }
+}
+
+#if OS_CFG_ENABLE_TIME_SLICING
+/**
+ * @brief   Charges a systick to the running task and moves it to the back of
+ *          its ready queue once its slice runs out. A task that's alone at its
+ *          priority level isn't charged at all. The switch itself happens on
+ *          the way out of the systick ISR.
+ * @note    Call this from within a critical section.
+ */
+static void _time_slice(void) {
+  os_tcb_t *task = os_curr_task;
+  os_queue_t *queue = &os_ctx.priorities[task->curr_prio];
+  if ((queue->first != task) || (task->next == OS_NULL)) {
+    return;
+  }
+  if (--task->slice_left == 0) {
+    task->slice_left = task->quantum;
+    os_queue_pop(queue);
+    os_queue_push(task, queue);
+  }
+}
+#endif
+
 void os_systick(void) {
   OS_DECLARE_CRITICAL();
+#if OS_CFG_ENABLE_TIMERS
+  os_timer_t *timer;
+#endif
   OS_ENTER_CRITICAL();
-  /* TODO: create a waiting list with delayed tasks */
-  for (os_size_t id = 0; id < OS_TASK_ID_CNT; id++) {
-    if (os_ctx.tcbs[id].delay) {
-      if (--os_ctx.tcbs[id].delay == 0) {
-        switch (os_ctx.tcbs[id].state) {
-        case OS_TASK_WAITING_FOR_EVENT:
-          os_event_timeout(&os_ctx.tcbs[id]);
-          break;
-        case OS_TASK_ASLEEP:
-          break;
-        default:
-          os_panic(OS_ERROR);
-        }
-        os_queue_push(&os_ctx.tcbs[id],
-                      &os_ctx.priorities[os_ctx.tcbs[id].curr_prio]);
-        OS_PRIORITY_READY(os_ctx.tcbs[id].curr_prio);
-        os_ctx.tcbs[id].state = OS_TASK_READY;
-      }
+  OS_TRACE(OS_TRACE_SYSTICK, 0);
+  if (os_ctx.delayed != OS_NULL) {
+    os_ctx.delayed->delay--;
+    _wake_expired();
+  }
+#if OS_CFG_ENABLE_TIME_SLICING
+  _time_slice();
+#endif
+#if OS_CFG_ENABLE_TIMERS
+  timer = os_ctx.timer_service.delayed;
+  if (timer != OS_NULL) {
+    timer->delay--;
+  }
+#endif
+  OS_EXIT_CRITICAL();
+#if OS_CFG_ENABLE_TIMERS
+  /* the expiry is handled outside, since callbacks may run right here */
+  if ((timer != OS_NULL) && (timer->delay == 0)) {
+    os_timer_advance(0);
+  }
+#endif
+}
+
+void os_systick_advance(os_size_t ticks) {
+  OS_DECLARE_CRITICAL();
+#if OS_CFG_ENABLE_TIMERS
+  os_timer_advance(ticks);
+#endif
+  OS_ENTER_CRITICAL();
+  while ((ticks != 0) && (os_ctx.delayed != OS_NULL)) {
+    if (os_ctx.delayed->delay > ticks) {
+      os_ctx.delayed->delay -= ticks;
+      break;
     }
+    ticks -= os_ctx.delayed->delay;
+    os_ctx.delayed->delay = 0;
+    _wake_expired();
   }
   OS_EXIT_CRITICAL();
 }
 
+os_size_t os_idle_ticks(void) {
+  if ((OS_BITMAP_GET_HIGHEST(os_ctx.ready_priorities) != 0) ||
+      (os_next_task != os_curr_task)) {
+    return 0;
+  }
+  os_size_t ticks = (os_ctx.delayed != OS_NULL) ? os_ctx.delayed->delay
+                                                 : OS_IDLE_TICKS_INFINITE;
+#if OS_CFG_ENABLE_TIMERS
+  os_timer_t *timer = os_ctx.timer_service.delayed;
+  if ((timer != OS_NULL) && (timer->delay < ticks)) {
+    ticks = timer->delay;
+  }
+#endif
+  if (ticks == OS_IDLE_TICKS_INFINITE) {
+    return OS_IDLE_TICKS_INFINITE;
+  }
+  return (ticks > 1) ? ticks : 0;
+}
+
+void os_delay_insert(os_tcb_t *task, os_size_t ticks) {
+  OS_ASSERT((task != OS_NULL), OS_NULL_PARAM);
+  task->delay_prev = OS_NULL;
+  task->delay_next = OS_NULL;
+  if (ticks == 0) {
+    task->delay = 0;
+    return;
+  }
+  os_tcb_t *prev = OS_NULL;
+  os_tcb_t *next = os_ctx.delayed;
+  while ((next != OS_NULL) && (next->delay <= ticks)) {
+    ticks -= next->delay;
+    prev = next;
+    next = next->delay_next;
+  }
+  task->delay = ticks;
+  task->delay_prev = prev;
+  task->delay_next = next;
+  if (next != OS_NULL) {
+    next->delay -= ticks;
+    next->delay_prev = task;
+  }
+  if (prev != OS_NULL) {
+    prev->delay_next = task;
+  } else {
+    os_ctx.delayed = task;
+  }
+}
+
+void os_delay_remove(os_tcb_t *task) {
+  if ((task->delay_prev == OS_NULL) && (os_ctx.delayed != task)) {
+    return;
+  }
+  if (task->delay_next != OS_NULL) {
+    task->delay_next->delay += task->delay;
+    task->delay_next->delay_prev = task->delay_prev;
+  }
+  if (task->delay_prev != OS_NULL) {
+    task->delay_prev->delay_next = task->delay_next;
+  } else {
+    os_ctx.delayed = task->delay_next;
+  }
+  task->delay_prev = OS_NULL;
+  task->delay_next = OS_NULL;
+  task->delay = 0;
+}
+
 void os_queue_push(os_tcb_t *task, os_queue_t *queue) {
   OS_ASSERT((task != OS_NULL) && (queue != OS_NULL), OS_NULL_PARAM);
   if (queue->first == OS_NULL) {
@@ -123,6 +619,7 @@ void os_queue_pop(os_queue_t *queue) {
     queue->last = OS_NULL;
   } else {
     queue->first = queue->first->next;
+    queue->first->prev = OS_NULL;
   }
 }
 
@@ -145,11 +642,22 @@ void os_update_priority(os_tcb_t *task, os_u8_t new_prio) {
   if (task->curr_prio == new_prio) {
     return;
   }
-  os_queue_remove(task, &os_ctx.priorities[task->curr_prio]);
-  OS_PRIORITY_UNREADY(task->curr_prio);
-  task->curr_prio = new_prio;
-  os_queue_push(task, &os_ctx.priorities[task->curr_prio]);
-  OS_PRIORITY_READY(task->curr_prio);
+  OS_TRACE(OS_TRACE_PRIORITY, ((os_u32_t)task->tid << 8) | new_prio);
+  switch (task->state) {
+  case OS_TASK_READY:
+  case OS_TASK_RUNNING:
+    os_queue_remove(task, &os_ctx.priorities[task->curr_prio]);
+    OS_PRIORITY_UNREADY(task->curr_prio);
+    task->curr_prio = new_prio;
+    os_queue_push(task, &os_ctx.priorities[task->curr_prio]);
+    OS_PRIORITY_READY(task->curr_prio);
+    break;
+  case OS_TASK_WAITING_FOR_EVENT:
+    os_event_update_priority(task, new_prio);
+    break;
+  default:
+    task->curr_prio = new_prio;
+  }
 }
 
 void os_enter_isr(void) {
@@ -157,48 +665,632 @@ void os_enter_isr(void) {
   OS_ENTER_CRITICAL();
   OS_ASSERT((os_ctx.isr_nesting_cnt != 255), OS_ISR_OVERFLOW);
   os_ctx.isr_nesting_cnt++;
+  OS_TRACE(OS_TRACE_ISR_ENTER, os_ctx.isr_nesting_cnt);
+  OS_EXIT_CRITICAL();
+}
+
+#if OS_CFG_ENABLE_ISR_POSTS
+#define OS_ISR_POST_MASK (OS_CFG_ISR_POST_QUEUE_DEPTH - 1U)
+
+static void _isr_posts_init(void) {
+  for (os_u32_t i = 0; i < OS_CFG_ISR_POST_QUEUE_DEPTH; i++) {
+    os_ctx.isr_posts.posts[i].seq = i;
+  }
+}
+
+static void _isr_post_run(os_isr_post_op_t op, os_event_id_t id,
+                          os_u32_t arg) {
+  OS_UNUSED(arg);
+  switch (op) {
+  case OS_ISR_POST_SEMAPHORE_GIVE:
+    os_semaphore_give(id);
+    break;
+#if OS_CFG_ENABLE_EVENT_FLAGS
+  case OS_ISR_POST_FLAGS_SET:
+    os_flags_set(id, arg);
+    break;
+#endif
+  default:
+    break;
+  }
+}
+
+/**
+ * @brief   Runs all completed posts. Only one caller drains at a time, a
+ *          nested ISR that finds the queue already draining leaves its posts
+ *          to the interrupted consumer.
+ */
+static void _isr_posts_drain(void) {
+  OS_DECLARE_CRITICAL();
+  os_isr_post_queue_t *queue = &os_ctx.isr_posts;
+  OS_ENTER_CRITICAL();
+  if (queue->draining) {
+    OS_EXIT_CRITICAL();
+    return;
+  }
+  queue->draining = OS_TRUE;
   OS_EXIT_CRITICAL();
+
+  while (1) {
+    os_isr_post_t *post = &queue->posts[queue->tail & OS_ISR_POST_MASK];
+    if (__atomic_load_n(&post->seq, __ATOMIC_ACQUIRE) != queue->tail + 1U) {
+      /* a post completed after the check would otherwise be left behind */
+      OS_ENTER_CRITICAL();
+      if (post->seq != queue->tail + 1U) {
+        queue->draining = OS_FALSE;
+        OS_EXIT_CRITICAL();
+        return;
+      }
+      OS_EXIT_CRITICAL();
+    }
+    os_isr_post_op_t op = post->op;
+    os_event_id_t id = post->id;
+    os_u32_t arg = post->arg;
+    __atomic_store_n(&post->seq, queue->tail + OS_CFG_ISR_POST_QUEUE_DEPTH,
+                     __ATOMIC_RELEASE);
+    queue->tail++;
+    _isr_post_run(op, id, arg);
+  }
 }
 
+os_error_t os_isr_post(os_isr_post_op_t op, os_event_id_t id, os_u32_t arg) {
+#if !OS_CFG_ENABLE_EVENT_FLAGS
+  /* the post would be dropped while draining */
+  if (op == OS_ISR_POST_FLAGS_SET) {
+    return OS_WRONG_EVENT;
+  }
+#endif
+  os_isr_post_queue_t *queue = &os_ctx.isr_posts;
+  os_u32_t pos = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+  os_isr_post_t *post;
+  while (1) {
+    post = &queue->posts[pos & OS_ISR_POST_MASK];
+    os_i32_t diff =
+        (os_i32_t)(__atomic_load_n(&post->seq, __ATOMIC_ACQUIRE) - pos);
+    if (diff == 0) {
+      if (__atomic_compare_exchange_n(&queue->head, &pos, pos + 1U, OS_TRUE,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return OS_QUEUE_FULL;
+    } else {
+      pos = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+    }
+  }
+  post->op = op;
+  post->id = id;
+  post->arg = arg;
+  __atomic_store_n(&post->seq, pos + 1U, __ATOMIC_RELEASE);
+
+  if (os_ctx.isr_nesting_cnt == 0) {
+    _isr_posts_drain();
+  }
+  return OS_OK;
+}
+#endif /* if OS_CFG_ENABLE_ISR_POSTS */
+
 void os_exit_isr(void) {
   OS_DECLARE_CRITICAL();
   OS_ENTER_CRITICAL();
   OS_ASSERT((os_ctx.isr_nesting_cnt != 0), OS_ISR_UNDERFLOW);
   os_ctx.isr_nesting_cnt--;
+  OS_TRACE(OS_TRACE_ISR_EXIT, os_ctx.isr_nesting_cnt);
+#if OS_CFG_ENABLE_ISR_POSTS
+  if ((os_ctx.isr_nesting_cnt == 0) &&
+      (os_ctx.isr_posts.head != os_ctx.isr_posts.tail)) {
+    /* posts are run with interrupts enabled */
+    OS_EXIT_CRITICAL();
+    _isr_posts_drain();
+    OS_ENTER_CRITICAL();
+  }
+#endif
   if (_set_next_task()) {
     OS_CTX_SWITCH_FROM_ISR();
   }
   OS_EXIT_CRITICAL();
 }
 
+#if OS_CFG_ENABLE_TIMERS
+
+/**
+ * @brief   Inserts a timer into the delta-ordered list of armed timers.
+ * @note    Call this from within a critical section.
+ * @param   [in] timer - timer to arm
+ * @param   [in] ticks - amount of systicks until the expiry, at least 1
+ */
+static void _timer_insert(os_timer_t *timer, os_size_t ticks) {
+  os_timer_t *prev = OS_NULL;
+  os_timer_t *next = os_ctx.timer_service.delayed;
+  while ((next != OS_NULL) && (next->delay <= ticks)) {
+    ticks -= next->delay;
+    prev = next;
+    next = next->next;
+  }
+  timer->delay = ticks;
+  timer->prev = prev;
+  timer->next = next;
+  if (next != OS_NULL) {
+    next->delay -= ticks;
+    next->prev = timer;
+  }
+  if (prev != OS_NULL) {
+    prev->next = timer;
+  } else {
+    os_ctx.timer_service.delayed = timer;
+  }
+  timer->active = OS_TRUE;
+}
+
+/**
+ * @brief   Removes a timer from the list of armed timers, if it's on it.
+ * @note    Call this from within a critical section.
+ */
+static void _timer_remove(os_timer_t *timer) {
+  if (!timer->active) {
+    return;
+  }
+  if (timer->next != OS_NULL) {
+    timer->next->delay += timer->delay;
+    timer->next->prev = timer->prev;
+  }
+  if (timer->prev != OS_NULL) {
+    timer->prev->next = timer->next;
+  } else {
+    os_ctx.timer_service.delayed = timer->next;
+  }
+  timer->prev = OS_NULL;
+  timer->next = OS_NULL;
+  timer->delay = 0;
+  timer->active = OS_FALSE;
+}
+
+/**
+ * @brief   Hands an expired timer to the service task and wakes it up. A timer
+ *          that's still pending from its previous expiry isn't queued twice.
+ * @note    Call this from within a critical section.
+ */
+static void _timer_queue(os_timer_t *timer) {
+  os_timer_service_t *service = &os_ctx.timer_service;
+  if (timer->pending) {
+    return;
+  }
+  timer->pending = OS_TRUE;
+  timer->pending_next = OS_NULL;
+  if (service->pending_last != OS_NULL) {
+    service->pending_last->pending_next = timer;
+  } else {
+    service->pending_first = timer;
+  }
+  service->pending_last = timer;
+  if (service->idle) {
+    service->idle = OS_FALSE;
+    service->task->state = OS_TASK_READY;
+    os_queue_push(service->task, &os_ctx.priorities[service->task->curr_prio]);
+    OS_PRIORITY_READY(service->task->curr_prio);
+  }
+}
+
+/**
+ * @brief   Drops a timer from the list of pending timers, if it's on it.
+ * @note    Call this from within a critical section.
+ */
+static void _timer_unqueue(os_timer_t *timer) {
+  os_timer_service_t *service = &os_ctx.timer_service;
+  os_timer_t *prev = OS_NULL;
+  if (!timer->pending) {
+    return;
+  }
+  for (os_timer_t *it = service->pending_first; it != timer;
+       it = it->pending_next) {
+    prev = it;
+  }
+  if (prev != OS_NULL) {
+    prev->pending_next = timer->pending_next;
+  } else {
+    service->pending_first = timer->pending_next;
+  }
+  if (service->pending_last == timer) {
+    service->pending_last = prev;
+  }
+  timer->pending = OS_FALSE;
+}
+
+void os_timer_init(os_timer_id_t id, os_size_t period, os_u8_t options,
+                   os_timer_func_t callback, void *param) {
+  OS_ASSERT((callback != OS_NULL), OS_NULL_PARAM);
+  os_timer_t *timer = &os_ctx.timers[id];
+  timer->period = period;
+  timer->options = options;
+  timer->callback = callback;
+  timer->param = param;
+  if (options & OS_TIMER_AUTOSTART) {
+    OS_ASSERT((period != 0), OS_ERROR);
+    _timer_insert(timer, period);
+  }
+}
+
+void os_timer_advance(os_size_t ticks) {
+  OS_DECLARE_CRITICAL();
+  os_timer_service_t *service = &os_ctx.timer_service;
+  OS_ENTER_CRITICAL();
+  while (service->delayed != OS_NULL) {
+    if (service->delayed->delay > ticks) {
+      service->delayed->delay -= ticks;
+      break;
+    }
+    ticks -= service->delayed->delay;
+    service->delayed->delay = 0;
+    while ((service->delayed != OS_NULL) && (service->delayed->delay == 0)) {
+      os_timer_t *timer = service->delayed;
+      _timer_remove(timer);
+      /* the next expiry is counted from this one, so periods don't drift */
+      if (timer->options & OS_TIMER_PERIODIC) {
+        _timer_insert(timer, timer->period);
+      }
+      if (timer->options & OS_TIMER_IN_ISR) {
+        OS_EXIT_CRITICAL();
+        timer->callback(timer->param);
+        OS_ENTER_CRITICAL();
+      } else {
+        _timer_queue(timer);
+      }
+    }
+  }
+  OS_EXIT_CRITICAL();
+}
+
+void os_timer_service(void) {
+  OS_DECLARE_CRITICAL();
+  os_timer_service_t *service = &os_ctx.timer_service;
+  service->task = os_curr_task;
+  while (1) {
+    OS_ENTER_CRITICAL();
+    os_timer_t *timer = service->pending_first;
+    if (timer == OS_NULL) {
+      /* sleeps without a timeout until _timer_queue() wakes it up */
+      service->idle = OS_TRUE;
+      os_curr_task->state = OS_TASK_ASLEEP;
+      os_queue_pop(&os_ctx.priorities[os_curr_task->curr_prio]);
+      OS_PRIORITY_UNREADY(os_curr_task->curr_prio);
+      OS_EXIT_CRITICAL();
+      os_schedule();
+      continue;
+    }
+    _timer_unqueue(timer);
+    os_timer_func_t callback = timer->callback;
+    void *param = timer->param;
+    OS_EXIT_CRITICAL();
+    callback(param);
+  }
+}
+
+os_error_t os_timer_start(os_timer_id_t id, os_size_t delay) {
+  OS_DECLARE_CRITICAL();
+  os_timer_t *timer = &os_ctx.timers[id];
+  OS_ENTER_CRITICAL();
+  if (delay == 0) {
+    delay = timer->period;
+  }
+  if ((delay == 0) ||
+      ((timer->options & OS_TIMER_PERIODIC) && (timer->period == 0))) {
+    OS_EXIT_CRITICAL();
+    return OS_ERROR;
+  }
+  _timer_remove(timer);
+  _timer_insert(timer, delay);
+  OS_EXIT_CRITICAL();
+  return OS_OK;
+}
+
+os_error_t os_timer_stop(os_timer_id_t id) {
+  OS_DECLARE_CRITICAL();
+  os_timer_t *timer = &os_ctx.timers[id];
+  OS_ENTER_CRITICAL();
+  _timer_remove(timer);
+  _timer_unqueue(timer);
+  OS_EXIT_CRITICAL();
+  return OS_OK;
+}
+
+os_error_t os_timer_set_period(os_timer_id_t id, os_size_t period) {
+  OS_DECLARE_CRITICAL();
+  os_timer_t *timer = &os_ctx.timers[id];
+  if ((period == 0) && (timer->options & OS_TIMER_PERIODIC)) {
+    return OS_ERROR;
+  }
+  OS_ENTER_CRITICAL();
+  timer->period = period;
+  OS_EXIT_CRITICAL();
+  return OS_OK;
+}
+
+os_bool_t os_timer_is_active(os_timer_id_t id) {
+  return os_ctx.timers[id].active;
+}
+
+#endif /* if OS_CFG_ENABLE_TIMERS */
+
+#if OS_CFG_ENABLE_TASK_NOTIFICATIONS
+/**
+ * @brief   Takes the pending notification of a task into @c notify_taken.
+ * @note    Call this from within a critical section.
+ */
+static void _notify_take(os_tcb_t *task) {
+  task->notify_taken = task->notify_value;
+  if (task->notify_clear) {
+    task->notify_value = 0;
+  } else if (task->notify_value != 0) {
+    task->notify_value--;
+  }
+  task->notify_pending = (task->notify_value != 0);
+}
+
+os_error_t os_task_notify(os_task_id_t id, os_notify_action_t action,
+                          os_u32_t value) {
+  OS_DECLARE_CRITICAL();
+  os_tcb_t *task = &os_ctx.tcbs[id];
+  OS_ENTER_CRITICAL();
+  if (task->state == OS_TASK_DELETED) {
+    OS_EXIT_CRITICAL();
+    return OS_ERROR;
+  }
+  switch (action) {
+  case OS_NOTIFY_INCREMENT:
+    task->notify_value++;
+    break;
+  case OS_NOTIFY_SET_BITS:
+    task->notify_value |= value;
+    break;
+  case OS_NOTIFY_OVERWRITE:
+    task->notify_value = value;
+    break;
+  default:
+    OS_EXIT_CRITICAL();
+    return OS_ERROR;
+  }
+  task->notify_pending = OS_TRUE;
+  OS_TRACE(OS_TRACE_NOTIFY, id);
+  if (task->state == OS_TASK_WAITING_FOR_NOTIFICATION) {
+    /* taken here, so the waiter doesn't need another critical section */
+    _notify_take(task);
+    os_delay_remove(task);
+    task->state = OS_TASK_READY;
+    os_queue_push(task, &os_ctx.priorities[task->curr_prio]);
+    OS_PRIORITY_READY(task->curr_prio);
+    OS_EXIT_CRITICAL();
+    os_schedule();
+  } else {
+    OS_EXIT_CRITICAL();
+  }
+  return OS_OK;
+}
+
+os_error_t os_task_notify_give(os_task_id_t id) {
+  return os_task_notify(id, OS_NOTIFY_INCREMENT, 0);
+}
+
+os_error_t os_task_notify_wait(os_bool_t clear, os_size_t timeout,
+                               os_u32_t *value) {
+  OS_DECLARE_CRITICAL();
+  os_tcb_t *task = os_curr_task;
+  OS_ENTER_CRITICAL();
+  task->notify_clear = clear;
+  if (task->notify_pending) {
+    _notify_take(task);
+    OS_EXIT_CRITICAL();
+  } else {
+    OS_TRACE(OS_TRACE_NOTIFY_BLOCK, 0);
+    task->wait_return = OS_WAIT_RET_OK;
+    task->state = OS_TASK_WAITING_FOR_NOTIFICATION;
+    os_delay_insert(task, timeout);
+    os_queue_pop(&os_ctx.priorities[task->curr_prio]);
+    OS_PRIORITY_UNREADY(task->curr_prio);
+    OS_EXIT_CRITICAL();
+    os_schedule();
+    if (task->wait_return == OS_WAIT_RET_TIMEOUT) {
+      return OS_TIMEOUT;
+    }
+  }
+  if (value != OS_NULL) {
+    *value = task->notify_taken;
+  }
+  return OS_OK;
+}
+#endif /* if OS_CFG_ENABLE_TASK_NOTIFICATIONS */
+
 void os_sleep(os_size_t ticks) {
   OS_DECLARE_CRITICAL();
   OS_ENTER_CRITICAL();
   os_curr_task->state = OS_TASK_ASLEEP;
-  os_curr_task->delay = ticks;
+  os_delay_insert(os_curr_task, ticks);
   os_queue_pop(&os_ctx.priorities[os_curr_task->curr_prio]);
   OS_PRIORITY_UNREADY(os_curr_task->curr_prio);
   OS_EXIT_CRITICAL();
   os_schedule();
 }
 
+os_task_id_t os_task_get_id(void) { return os_curr_task->tid; }
+
+#if OS_CFG_ENABLE_DYNAMIC_TASKS
+/**
+ * @brief   Frees the slots of the pool tasks that deleted themselves. Those
+ *          ran on their stacks until they were switched out, which is done by
+ *          the time another task calls this.
+ * @note    Call this from within a critical section.
+ */
+static void _task_reap(void) {
+  while (os_ctx.exited_tasks != OS_NULL) {
+    os_tcb_t *task = os_ctx.exited_tasks;
+    os_ctx.exited_tasks = task->next;
+    task->next = os_ctx.free_tasks;
+    os_ctx.free_tasks = task;
+  }
+}
+
+os_error_t os_task_create(os_task_id_t *id, os_u8_t priority,
+                          os_task_func_t entry_func, void *param) {
+  OS_DECLARE_CRITICAL();
+  if (entry_func == OS_NULL) {
+    return OS_NULL_PARAM;
+  }
+  if ((priority == 0) || (priority >= OS_PRIORITY_LEVEL_CNT)) {
+    return OS_ERROR;
+  }
+  OS_ENTER_CRITICAL();
+  _task_reap();
+  os_tcb_t *task = os_ctx.free_tasks;
+  if (task == OS_NULL) {
+    OS_EXIT_CRITICAL();
+    return OS_TASK_POOL_EMPTY;
+  }
+  os_ctx.free_tasks = task->next;
+  OS_EXIT_CRITICAL();
+
+  /* the slot is ours now, so the stack is set up with interrupts enabled */
+  os_task_id_t tid = (os_task_id_t)(task - os_ctx.tcbs);
+  os_task_desc_t desc = {
+      .stack = _task_stack(tid),
+      .stack_size =
+          OS_PORT_BYTES_TO_SECTORS(OS_CFG_DYNAMIC_TASK_STACK_SIZE),
+      .entry_func = entry_func,
+      .entry_func_param = param,
+      OS_TASK_DESC_QUANTUM(0).priority = priority,
+  };
+  *task = (os_tcb_t){.state = OS_TASK_DELETED};
+  _init_tcb(tid, &desc);
+
+  OS_ENTER_CRITICAL();
+  _start_tcb(task);
+  OS_EXIT_CRITICAL();
+  if (id != OS_NULL) {
+    *id = tid;
+  }
+  os_schedule();
+  return OS_OK;
+}
+
+os_error_t os_task_delete(os_task_id_t id) {
+  OS_DECLARE_CRITICAL();
+  if (id >= OS_TASK_SLOT_CNT) {
+    return OS_ERROR;
+  }
+  os_tcb_t *task = &os_ctx.tcbs[id];
+  /* the idle task needs to be ready at all times */
+  if (task->base_prio == 0) {
+    return OS_ERROR;
+  }
+#if OS_CFG_ENABLE_TIMERS
+  /* _timer_queue() readies the service task without checking its state */
+  if (task == os_ctx.timer_service.task) {
+    return OS_ERROR;
+  }
+#endif
+  OS_ENTER_CRITICAL();
+  switch (task->state) {
+  case OS_TASK_DELETED:
+    OS_EXIT_CRITICAL();
+    return OS_ERROR;
+  case OS_TASK_READY:
+  case OS_TASK_RUNNING:
+    os_queue_remove(task, &os_ctx.priorities[task->curr_prio]);
+    OS_PRIORITY_UNREADY(task->curr_prio);
+    break;
+  case OS_TASK_WAITING_FOR_EVENT:
+    os_event_abort(task);
+    os_delay_remove(task);
+    break;
+  default:
+    os_delay_remove(task);
+  }
+  os_event_release_locks(task);
+  task->state = OS_TASK_DELETED;
+  if (id >= OS_TASK_ID_CNT) {
+    /* a task that deletes itself runs on its stack until it's switched out */
+    os_tcb_t **list =
+        (task == os_curr_task) ? &os_ctx.exited_tasks : &os_ctx.free_tasks;
+    task->next = *list;
+    *list = task;
+  }
+  OS_EXIT_CRITICAL();
+  os_schedule();
+  return OS_OK;
+}
+#endif
+
 void os_init() {
-#define OS_TASK(_id, _priority, _stack_size, _entry_func, _entry_func_param)   \
-  _init_tcb(_id, _priority, OS_PORT_BYTES_TO_SECTORS(_stack_size),             \
-            os_stack_##_id, _entry_func, _entry_func_param);
-  OS_TASK_DEFINITIONS
-#undef OS_TASK
+#if OS_CFG_ENABLE_STATS || OS_CFG_ENABLE_CRITICAL_PROFILER
+  os_port_cycle_counter_init();
+#endif
+  if (OS_PRIORITY_IS_FLAT) {
+    os_ctx.ready_priorities.levels[0] = os_ready_priorities_flat;
+  }
+  for (os_size_t id = 0; id < OS_TASK_ID_CNT; id++) {
+    _init_tcb(id, &os_task_descs[id]);
+    _start_tcb(&os_ctx.tcbs[id]);
+  }
 
-#define OS_MUTEX(_id) os_event_init(_id, OS_EVENT_MUTEX, 0);
-  OS_MUTEX_DEFINITIONS
-#undef OS_MUTEX
+#if OS_CFG_ENABLE_DYNAMIC_TASKS
+  for (os_size_t id = OS_TASK_SLOT_CNT; id > OS_TASK_ID_CNT; id--) {
+    os_tcb_t *task = &os_ctx.tcbs[id - 1];
+    task->state = OS_TASK_DELETED;
+    task->next = os_ctx.free_tasks;
+    os_ctx.free_tasks = task;
+  }
+#endif
 
-#define OS_SEMAPHORE(_id, _count)                                              \
-  os_event_init(_id, OS_EVENT_SEMAPHORE, _count);
-  OS_SEMAPHORE_DEFINITIONS
-#undef OS_SEMAPHORE
+  for (os_size_t id = 0; id < OS_EVENT_ID_CNT; id++) {
+    os_ctx.events[id].type = os_event_descs[id].type;
+    os_ctx.events[id].count = os_event_descs[id].count;
+  }
+
+#if OS_CFG_ENABLE_RWLOCKS
+#define OS_RWLOCK(_id) os_ctx.events[_id].data.rwlock = &os_rwlock_##_id;
+  OS_RWLOCK_DEFINITIONS
+#undef OS_RWLOCK
+#endif
+
+#if OS_CFG_ENABLE_MESSAGE_QUEUES
+#define OS_MSGQ(_id, _msg_size, _depth)                                        \
+  os_msgq_init(_id, os_msgq_buffer_##_id, _msg_size, _depth);
+  OS_MSGQ_DEFINITIONS
+#undef OS_MSGQ
+#endif
+
+#if OS_CFG_ENABLE_RING_BUFFERS
+#define OS_RING(_id, _record_size, _depth, _wake_level)                        \
+  os_ring_init(_id, os_ring_buffer_##_id, _record_size, _depth, _wake_level);
+  OS_RING_DEFINITIONS
+#undef OS_RING
+#endif
+
+#if OS_CFG_ENABLE_MEMORY_POOLS
+#define OS_POOL(_id, _block_size, _block_cnt)                                  \
+  os_pool_init(_id, os_pool_buffer_##_id, OS_POOL_BLOCK_WORDS(_block_size),    \
+               _block_cnt);
+  OS_POOL_DEFINITIONS
+#undef OS_POOL
+#endif
+
+#if OS_CFG_ENABLE_ISR_POSTS
+  _isr_posts_init();
+#endif
+
+#if OS_CFG_ENABLE_TIMERS
+#define OS_TIMER(_id, _period, _options, _callback, _param)                    \
+  os_timer_init(_id, _period, _options, _callback, _param);
+  OS_TIMER_DEFINITIONS
+#undef OS_TIMER
+#endif
+
+#if OS_CFG_ENABLE_STATS
+  os_ctx.stats_switch_time = os_port_get_cycles();
+#endif
 
   if (_set_next_task()) {
+#if OS_CFG_ENABLE_STACK_GUARD
+    _stack_guard(os_next_task);
+#endif
     os_port_startup();
   }
   os_panic(OS_STARTUP_EXITED);
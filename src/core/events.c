@@ -1,29 +1,236 @@
 #include "private.h"
 
 /**
- * @brief   Gets the last highest priority task in a mutex queue. Tasks are
- * always inserted at the beginning of a queue, so the last task with a given
- * priority is waiting for the longest time.
- * @param   [in] event - pointer to a mutex struct
+ * @brief   Pushes a task to the wait queue of an event, behind the tasks
+ * with the same or a higher priority.
+ * @note    Call this from within a critical section.
+ * @param   [in] task - pointer to the waiting task
+ * @param   [in] event - pointer to an event struct
+ */
+static void _wait_push(os_tcb_t *task, os_event_t *event);
+
+/**
+ * @brief   Removes a task from the wait queue of an event.
+ * @note    Call this from within a critical section.
+ * @param   [in] task - pointer to the waiting task
+ * @param   [in] event - pointer to an event struct
+ */
+static void _wait_remove(os_tcb_t *task, os_event_t *event);
+
+/**
+ * @brief   Gets the highest priority task waiting for an event. Tasks with
+ * equal priorities are served in FIFO order.
+ * @param   [in] event - pointer to an event struct
  * @return  os_tcb_t* - pointer to the task
  */
-static os_tcb_t *_mutex_get_next(const os_event_t *const event);
+static os_tcb_t *_wait_get_next(const os_event_t *const event);
+
+/**
+ * @brief   Blocks the current task on an event.
+ * @note    Call this from within a critical section and call os_schedule()
+ *          after leaving it.
+ * @param   [in] event - pointer to an event struct
+ * @param   [in] timeout - timeout in systicks, 0 waits indefinitely
+ */
+static void _wait_for_event(os_event_t *event, os_size_t timeout);
+
+/**
+ * @brief   Removes a task from the wait queue of an event and makes it ready.
+ * @note    Call this from within a critical section.
+ * @param   [in] task - pointer to the waiting task
+ * @param   [in] event - pointer to an event struct
+ */
+static void _wake_up(os_tcb_t *task, os_event_t *event);
+
+/**
+ * @brief   Translates the wait return of the current task.
+ * @return  OS_OK - the event was signalled; OS_TIMEOUT - the wait timed out
+ */
+static os_error_t _wait_result(void);
+
+/**
+ * @brief   Adds a lock to the list of locks a task holds.
+ * @note    Call this from within a critical section.
+ * @param   [out] hold - link of the lock to the task
+ * @param   [in] task - pointer to the new holder
+ * @param   [in] event - pointer to the lock
+ */
+static void _hold_add(os_hold_t *hold, os_tcb_t *task, os_event_t *event);
+
+/**
+ * @brief   Removes a lock from the list of locks its holder holds.
+ * @note    Call this from within a critical section.
+ * @param   [in] hold - link of the lock to its holder
+ */
+static void _hold_remove(os_hold_t *hold);
+
+/**
+ * @brief   Returns the priority a task inherits from the locks it holds: the
+ * highest of its base priority and the priorities of the first tasks waiting
+ * for any of its mutexes and reader-writer locks.
+ * @note    Call this from within a critical section.
+ * @param   [in] task - pointer to a task struct
+ */
+static os_u8_t _holder_priority(const os_tcb_t *task);
+
+/**
+ * @brief   Sets the priority of a mutex holder to the priority it inherits
+ * from all the locks it holds.
+ * @note    Call this from within a critical section.
+ * @param   [in] event - pointer to a mutex struct
+ */
+static void _mutex_inherit_priority(os_event_t *event);
+
+#if OS_CFG_ENABLE_RWLOCKS
+/**
+ * @brief   Sets the priority of every holder of a reader-writer lock to the
+ * priority it inherits from all the locks it holds.
+ * @note    Call this from within a critical section.
+ * @param   [in] event - pointer to a reader-writer lock struct
+ */
+static void _rwlock_inherit_priority(os_event_t *event);
+
+/**
+ * @brief   Hands a reader-writer lock to the waiting tasks in priority order,
+ * until it reaches a writer that has to wait for the readers, or runs out of
+ * reader slots. The priorities of the new holders are updated afterwards.
+ * @note    Call this from within a critical section and call os_schedule()
+ *          after leaving it.
+ * @param   [in] event - pointer to a reader-writer lock struct
+ */
+static void _rwlock_grant(os_event_t *event);
+#endif
 
-static os_tcb_t *_mutex_get_next(const os_event_t *const event) {
-  if (event->queue.first == OS_NULL) {
-    return OS_NULL;
+static void _wait_push(os_tcb_t *task, os_event_t *event) {
+  os_tcb_t *prev = event->waiting.last;
+  while ((prev != OS_NULL) && (prev->curr_prio < task->curr_prio)) {
+    prev = prev->prev;
+  }
+  if (prev == event->waiting.last) {
+    os_queue_push(task, &event->waiting);
+    return;
   }
-  os_tcb_t *high_prio_task = event->queue.first;
-  os_tcb_t *next_task = high_prio_task->next;
-  while (next_task != OS_NULL) {
-    if (next_task->curr_prio >= high_prio_task->curr_prio) {
-      high_prio_task = next_task;
+  task->prev = prev;
+  if (prev == OS_NULL) {
+    task->next = event->waiting.first;
+    event->waiting.first = task;
+  } else {
+    task->next = prev->next;
+    prev->next = task;
+  }
+  task->next->prev = task;
+}
+
+static void _wait_remove(os_tcb_t *task, os_event_t *event) {
+  os_queue_remove(task, &event->waiting);
+}
+
+static os_tcb_t *_wait_get_next(const os_event_t *const event) {
+  return event->waiting.first;
+}
+
+static void _wait_for_event(os_event_t *event, os_size_t timeout) {
+  os_curr_task->wait_return = OS_WAIT_RET_OK;
+  os_curr_task->state = OS_TASK_WAITING_FOR_EVENT;
+  os_delay_insert(os_curr_task, timeout);
+  os_curr_task->wait_event = event;
+  os_queue_pop(&os_ctx.priorities[os_curr_task->curr_prio]);
+  OS_PRIORITY_UNREADY(os_curr_task->curr_prio);
+  _wait_push(os_curr_task, event);
+}
+
+static void _wake_up(os_tcb_t *task, os_event_t *event) {
+  _wait_remove(task, event);
+  os_delay_remove(task);
+  task->state = OS_TASK_READY;
+  os_queue_push(task, &os_ctx.priorities[task->curr_prio]);
+  OS_PRIORITY_READY(task->curr_prio);
+}
+
+static os_error_t _wait_result(void) {
+  switch (os_curr_task->wait_return) {
+  case OS_WAIT_RET_OK:
+    return OS_OK;
+  case OS_WAIT_RET_TIMEOUT:
+    return OS_TIMEOUT;
+  default:
+    return OS_ERROR;
+  }
+}
+
+static void _hold_add(os_hold_t *hold, os_tcb_t *task, os_event_t *event) {
+  hold->task = task;
+  hold->event = event;
+  hold->prev = OS_NULL;
+  hold->next = task->held;
+  if (task->held != OS_NULL) {
+    task->held->prev = hold;
+  }
+  task->held = hold;
+}
+
+static void _hold_remove(os_hold_t *hold) {
+  if (hold->prev != OS_NULL) {
+    hold->prev->next = hold->next;
+  } else {
+    hold->task->held = hold->next;
+  }
+  if (hold->next != OS_NULL) {
+    hold->next->prev = hold->prev;
+  }
+}
+
+static os_u8_t _holder_priority(const os_tcb_t *task) {
+  os_u8_t prio = task->base_prio;
+  for (const os_hold_t *hold = task->held; hold != OS_NULL;
+       hold = hold->next) {
+    const os_tcb_t *waiter = hold->event->waiting.first;
+    if ((waiter != OS_NULL) && (waiter->curr_prio > prio)) {
+      prio = waiter->curr_prio;
     }
-    next_task = next_task->next;
   }
-  return high_prio_task;
+  return prio;
+}
+
+static void _mutex_inherit_priority(os_event_t *event) {
+  os_update_priority(event->holder, _holder_priority(event->holder));
 }
 
+#if OS_CFG_ENABLE_RWLOCKS
+static void _rwlock_inherit_priority(os_event_t *event) {
+  if (event->holder != OS_NULL) {
+    os_update_priority(event->holder, _holder_priority(event->holder));
+  }
+  for (os_size_t i = 0; i < event->count; i++) {
+    os_tcb_t *reader = event->data.rwlock->readers[i].task;
+    os_update_priority(reader, _holder_priority(reader));
+  }
+}
+
+static void _rwlock_grant(os_event_t *event) {
+  while (event->holder == OS_NULL) {
+    os_tcb_t *task = _wait_get_next(event);
+    if (task == OS_NULL) {
+      break;
+    }
+    if (task->rwlock_write) {
+      if (event->count != 0) {
+        break;
+      }
+      event->holder = task;
+      _hold_add(&event->data.rwlock->writer, task, event);
+    } else {
+      if (event->count == OS_CFG_RWLOCK_READER_CNT) {
+        break;
+      }
+      _hold_add(&event->data.rwlock->readers[event->count++], task, event);
+    }
+    _wake_up(task, event);
+  }
+  _rwlock_inherit_priority(event);
+}
+#endif
+
 void os_event_init(os_event_id_t id, os_event_type_t type, os_u32_t count) {
   OS_ASSERT((os_ctx.events[id].type == OS_EVENT_UNINITIALIZED),
             OS_EVENT_INITIALIZED);
@@ -37,135 +244,819 @@ void os_event_timeout(os_tcb_t *task) {
   OS_ASSERT((task->wait_event->type != OS_EVENT_UNINITIALIZED) &&
                 (task->wait_event->type < OS_EVENT_TOP),
             OS_WRONG_EVENT);
+  OS_TRACE(OS_TRACE_TIMEOUT, task->tid);
   task->wait_return = OS_WAIT_RET_TIMEOUT;
-  os_queue_remove(task, &task->wait_event->queue);
+  os_event_abort(task);
+  OS_EXIT_CRITICAL();
+}
+
+void os_event_abort(os_tcb_t *task) {
+  _wait_remove(task, task->wait_event);
   if (task->wait_event->type == OS_EVENT_MUTEX) {
-    os_tcb_t *holder = task->wait_event->holder;
-    os_tcb_t *high_prio_task = _mutex_get_next(task->wait_event);
-    os_update_priority(holder, (high_prio_task != OS_NULL)
-                                   ? high_prio_task->curr_prio
-                                   : holder->base_prio);
+    _mutex_inherit_priority(task->wait_event);
+  }
+#if OS_CFG_ENABLE_RWLOCKS
+  /* readers that queued behind a leaving writer may get the lock now */
+  if (task->wait_event->type == OS_EVENT_RWLOCK) {
+    _rwlock_grant(task->wait_event);
+  }
+#endif
+}
+
+#if OS_CFG_ENABLE_RWLOCKS
+/**
+ * @brief   Drops a task from the holders of a reader-writer lock.
+ * @return  OS_TRUE - the task held the lock
+ */
+static os_bool_t _rwlock_release(os_event_t *event, os_tcb_t *task) {
+  os_rwlock_t *rwlock = event->data.rwlock;
+  if (event->holder == task) {
+    event->holder = OS_NULL;
+    _hold_remove(&rwlock->writer);
+    return OS_TRUE;
+  }
+  for (os_size_t i = 0; i < event->count; i++) {
+    if (rwlock->readers[i].task == task) {
+      _hold_remove(&rwlock->readers[i]);
+      /* the last reader moves into the slot, so its link moves as well */
+      os_hold_t *last = &rwlock->readers[--event->count];
+      if (last != &rwlock->readers[i]) {
+        _hold_remove(last);
+        _hold_add(&rwlock->readers[i], last->task, event);
+      }
+      return OS_TRUE;
+    }
+  }
+  return OS_FALSE;
+}
+#endif
+
+#if OS_CFG_ENABLE_DYNAMIC_TASKS
+void os_event_release_locks(os_tcb_t *task) {
+  while (task->held != OS_NULL) {
+    os_event_t *event = task->held->event;
+#if OS_CFG_ENABLE_RWLOCKS
+    if (event->type == OS_EVENT_RWLOCK) {
+      _rwlock_release(event, task);
+      _rwlock_grant(event);
+      continue;
+    }
+#endif
+    _hold_remove(&event->data.mutex);
+    event->holder = _wait_get_next(event);
+    if (event->holder != OS_NULL) {
+      _hold_add(&event->data.mutex, event->holder, event);
+      _wake_up(event->holder, event);
+      /* the tasks still waiting are now blocked by the new holder */
+      _mutex_inherit_priority(event);
+    }
   }
-  OS_EXIT_CRITICAL();
 }
+#endif
 
+void os_event_update_priority(os_tcb_t *task, os_u8_t new_prio) {
+  os_event_t *event = task->wait_event;
+  _wait_remove(task, event);
+  task->curr_prio = new_prio;
+  _wait_push(task, event);
+  if (event->type == OS_EVENT_MUTEX) {
+    _mutex_inherit_priority(event);
+  }
+#if OS_CFG_ENABLE_RWLOCKS
+  if (event->type == OS_EVENT_RWLOCK) {
+    _rwlock_inherit_priority(event);
+  }
+#endif
+}
+
+/*
+ * The uncontended paths of the mutex and semaphore calls below make no calls
+ * and don't schedule. The type of an event is set once by os_init(), so it's
+ * checked before entering the critical section.
+ */
 os_error_t os_mutex_take(os_event_id_t id, os_size_t timeout) {
   OS_DECLARE_CRITICAL();
+  os_event_t *event = &os_ctx.events[id];
+  if (event->type != OS_EVENT_MUTEX) {
+    return OS_WRONG_EVENT;
+  }
   OS_ENTER_CRITICAL();
-  if (os_ctx.events[id].type != OS_EVENT_MUTEX) {
+  os_tcb_t *holder = event->holder;
+  if (holder == OS_NULL) {
+    event->holder = os_curr_task;
+    _hold_add(&event->data.mutex, os_curr_task, event);
+    OS_TRACE(OS_TRACE_MUTEX_TAKE, id);
     OS_EXIT_CRITICAL();
+    return OS_OK;
+  }
+  OS_TRACE(OS_TRACE_MUTEX_BLOCK, id);
+  _wait_for_event(event, timeout);
+  if (holder->curr_prio < os_curr_task->curr_prio) {
+    os_update_priority(holder, os_curr_task->curr_prio);
+  }
+  OS_EXIT_CRITICAL();
+  os_schedule();
+  return _wait_result();
+}
+
+os_error_t os_mutex_give(os_event_id_t id) {
+  OS_DECLARE_CRITICAL();
+  os_event_t *event = &os_ctx.events[id];
+  if (event->type != OS_EVENT_MUTEX) {
     return OS_WRONG_EVENT;
   }
-  os_curr_task->wait_return = OS_WAIT_RET_OK;
-  os_tcb_t *holder = os_ctx.events[id].holder;
-  if (holder != OS_NULL) {
-    os_curr_task->state = OS_TASK_WAITING_FOR_EVENT;
-    os_curr_task->delay = timeout;
-    os_curr_task->wait_event = &os_ctx.events[id];
-    os_queue_pop(&os_ctx.priorities[os_curr_task->curr_prio]);
-    OS_PRIORITY_UNREADY(os_curr_task->curr_prio);
-    if (holder->curr_prio < os_curr_task->curr_prio) {
-      os_update_priority(holder, os_curr_task->curr_prio);
+  OS_ENTER_CRITICAL();
+  OS_TRACE(OS_TRACE_MUTEX_GIVE, id);
+  if (event->holder != OS_NULL) {
+    _hold_remove(&event->data.mutex);
+  }
+  if ((os_curr_task->curr_prio == os_curr_task->base_prio) &&
+      (event->waiting.first == OS_NULL)) {
+    event->holder = OS_NULL;
+    OS_EXIT_CRITICAL();
+    return OS_OK;
+  }
+  os_tcb_t *high_prio_task = _wait_get_next(event);
+  event->holder = high_prio_task;
+  if (high_prio_task != OS_NULL) {
+    _hold_add(&event->data.mutex, high_prio_task, event);
+    _wake_up(high_prio_task, event);
+    /* the tasks still waiting are now blocked by the new holder */
+    _mutex_inherit_priority(event);
+  }
+  /* other locks held by the task may still keep its priority up */
+  os_update_priority(os_curr_task, _holder_priority(os_curr_task));
+  OS_EXIT_CRITICAL();
+  if (high_prio_task != OS_NULL) {
+    os_schedule();
+  }
+  return OS_OK;
+}
+
+os_error_t os_semaphore_take(os_event_id_t id, os_size_t timeout) {
+  OS_DECLARE_CRITICAL();
+  os_event_t *event = &os_ctx.events[id];
+  if (event->type != OS_EVENT_SEMAPHORE) {
+    return OS_WRONG_EVENT;
+  }
+  OS_ENTER_CRITICAL();
+  if (event->count != 0) {
+    event->count--;
+    OS_TRACE(OS_TRACE_SEMAPHORE_TAKE, id);
+    OS_EXIT_CRITICAL();
+    return OS_OK;
+  }
+  OS_TRACE(OS_TRACE_SEMAPHORE_BLOCK, id);
+  _wait_for_event(event, timeout);
+  OS_EXIT_CRITICAL();
+  os_schedule();
+  return _wait_result();
+}
+
+os_error_t os_semaphore_give(os_event_id_t id) {
+  OS_DECLARE_CRITICAL();
+  os_event_t *event = &os_ctx.events[id];
+  if (event->type != OS_EVENT_SEMAPHORE) {
+    return OS_WRONG_EVENT;
+  }
+  OS_ENTER_CRITICAL();
+  OS_TRACE(OS_TRACE_SEMAPHORE_GIVE, id);
+  if (event->waiting.first == OS_NULL) {
+    event->count++;
+    OS_EXIT_CRITICAL();
+    return OS_OK;
+  }
+  _wake_up(_wait_get_next(event), event);
+  OS_EXIT_CRITICAL();
+  os_schedule();
+  return OS_OK;
+}
+
+#if OS_CFG_ENABLE_RWLOCKS
+/**
+ * @brief   Raises the priority of every holder of a reader-writer lock to at
+ * least the priority of the current task, which has just blocked on it.
+ * @note    Call this from within a critical section.
+ */
+static void _rwlock_boost_holders(os_event_t *event) {
+  os_u8_t prio = os_curr_task->curr_prio;
+  if ((event->holder != OS_NULL) && (event->holder->curr_prio < prio)) {
+    os_update_priority(event->holder, prio);
+  }
+  for (os_size_t i = 0; i < event->count; i++) {
+    os_tcb_t *reader = event->data.rwlock->readers[i].task;
+    if (reader->curr_prio < prio) {
+      os_update_priority(reader, prio);
     }
-    os_queue_push(os_curr_task, &os_ctx.events[id].queue);
+  }
+}
+
+/**
+ * @brief   Hands a reader-writer lock on after the current task has been
+ * dropped from its holders, and recomputes the priority of the task from the
+ * locks it still holds.
+ * @note    Call this from within a critical section.
+ * @return  OS_TRUE - os_schedule() needs to be called after leaving it
+ */
+static os_bool_t _rwlock_hand_over(os_event_t *event) {
+  if ((os_curr_task->curr_prio == os_curr_task->base_prio) &&
+      (event->waiting.first == OS_NULL)) {
+    return OS_FALSE;
+  }
+  _rwlock_grant(event);
+  os_update_priority(os_curr_task, _holder_priority(os_curr_task));
+  return OS_TRUE;
+}
+
+os_error_t os_rwlock_read_take(os_event_id_t id, os_size_t timeout) {
+  OS_DECLARE_CRITICAL();
+  os_event_t *event = &os_ctx.events[id];
+  if (event->type != OS_EVENT_RWLOCK) {
+    return OS_WRONG_EVENT;
+  }
+  OS_ENTER_CRITICAL();
+  /* tasks only wait on a free lock for as long as a writer queues ahead */
+  if ((event->holder == OS_NULL) &&
+      (event->count < OS_CFG_RWLOCK_READER_CNT) &&
+      ((event->waiting.first == OS_NULL) ||
+       (event->waiting.first->curr_prio <
+        os_curr_task->curr_prio))) {
+    _hold_add(&event->data.rwlock->readers[event->count++], os_curr_task,
+              event);
+    OS_TRACE(OS_TRACE_RWLOCK_READ, id);
     OS_EXIT_CRITICAL();
+    return OS_OK;
+  }
+  OS_TRACE(OS_TRACE_RWLOCK_BLOCK, id);
+  os_curr_task->rwlock_write = OS_FALSE;
+  _wait_for_event(event, timeout);
+  _rwlock_boost_holders(event);
+  OS_EXIT_CRITICAL();
+  os_schedule();
+  return _wait_result();
+}
+
+os_error_t os_rwlock_read_give(os_event_id_t id) {
+  OS_DECLARE_CRITICAL();
+  os_event_t *event = &os_ctx.events[id];
+  if (event->type != OS_EVENT_RWLOCK) {
+    return OS_WRONG_EVENT;
+  }
+  OS_ENTER_CRITICAL();
+  if ((event->holder == os_curr_task) ||
+      !_rwlock_release(event, os_curr_task)) {
+    OS_EXIT_CRITICAL();
+    return OS_ERROR;
+  }
+  OS_TRACE(OS_TRACE_RWLOCK_GIVE, id);
+  os_bool_t reschedule = _rwlock_hand_over(event);
+  OS_EXIT_CRITICAL();
+  if (reschedule) {
     os_schedule();
+  }
+  return OS_OK;
+}
+
+os_error_t os_rwlock_write_take(os_event_id_t id, os_size_t timeout) {
+  OS_DECLARE_CRITICAL();
+  os_event_t *event = &os_ctx.events[id];
+  if (event->type != OS_EVENT_RWLOCK) {
+    return OS_WRONG_EVENT;
+  }
+  OS_ENTER_CRITICAL();
+  if ((event->holder == OS_NULL) && (event->count == 0)) {
+    event->holder = os_curr_task;
+    _hold_add(&event->data.rwlock->writer, os_curr_task, event);
+    OS_TRACE(OS_TRACE_RWLOCK_WRITE, id);
+    OS_EXIT_CRITICAL();
+    return OS_OK;
+  }
+  OS_TRACE(OS_TRACE_RWLOCK_BLOCK, id);
+  os_curr_task->rwlock_write = OS_TRUE;
+  _wait_for_event(event, timeout);
+  _rwlock_boost_holders(event);
+  OS_EXIT_CRITICAL();
+  os_schedule();
+  return _wait_result();
+}
+
+os_error_t os_rwlock_write_give(os_event_id_t id) {
+  OS_DECLARE_CRITICAL();
+  os_event_t *event = &os_ctx.events[id];
+  if (event->type != OS_EVENT_RWLOCK) {
+    return OS_WRONG_EVENT;
+  }
+  OS_ENTER_CRITICAL();
+  if (event->holder != os_curr_task) {
+    OS_EXIT_CRITICAL();
+    return OS_ERROR;
+  }
+  event->holder = OS_NULL;
+  _hold_remove(&event->data.rwlock->writer);
+  OS_TRACE(OS_TRACE_RWLOCK_GIVE, id);
+  os_bool_t reschedule = _rwlock_hand_over(event);
+  OS_EXIT_CRITICAL();
+  if (reschedule) {
+    os_schedule();
+  }
+  return OS_OK;
+}
+#endif /* if OS_CFG_ENABLE_RWLOCKS */
+
+#if OS_CFG_ENABLE_MESSAGE_QUEUES || OS_CFG_ENABLE_RING_BUFFERS
+/**
+ * @brief   Copies a message.
+ */
+static void _msg_copy(void *dst, const void *src, os_size_t size) {
+  os_u8_t *dst_ptr = (os_u8_t *)dst;
+  const os_u8_t *src_ptr = (const os_u8_t *)src;
+  while (size--) {
+    *dst_ptr++ = *src_ptr++;
+  }
+}
+#endif
+
+#if OS_CFG_ENABLE_MESSAGE_QUEUES
+
+/**
+ * @brief   Copies a message into a queue's buffer.
+ * @note    Call this from within a critical section.
+ * @warning The queue can't be full.
+ */
+static void _msgq_push(os_event_t *event, const void *msg, os_bool_t to_front) {
+  os_msgq_t *msgq = &event->data.msgq;
+  os_size_t slot;
+  if (to_front) {
+    msgq->head = (msgq->head == 0) ? msgq->depth - 1 : msgq->head - 1;
+    slot = msgq->head;
   } else {
-    os_ctx.events[id].holder = os_curr_task;
+    slot = msgq->head + event->count;
+    if (slot >= msgq->depth) {
+      slot -= msgq->depth;
+    }
+  }
+  _msg_copy(&msgq->buffer[slot * msgq->msg_size], msg, msgq->msg_size);
+  event->count++;
+}
+
+/**
+ * @brief   Copies the first message out of a queue's buffer.
+ * @note    Call this from within a critical section.
+ * @warning The queue can't be empty.
+ */
+static void _msgq_pop(os_event_t *event, void *msg) {
+  os_msgq_t *msgq = &event->data.msgq;
+  _msg_copy(msg, &msgq->buffer[msgq->head * msgq->msg_size], msgq->msg_size);
+  if (++msgq->head == msgq->depth) {
+    msgq->head = 0;
+  }
+  event->count--;
+}
+
+/**
+ * @brief   Sends a message. A waiting receiver gets the message copied
+ * directly into its buffer.
+ * @param   [in] can_wait - OS_FALSE returns OS_QUEUE_FULL instead of blocking
+ */
+static os_error_t _msgq_send(os_event_id_t id, const void *msg,
+                             os_size_t timeout, os_bool_t to_front,
+                             os_bool_t can_wait) {
+  OS_DECLARE_CRITICAL();
+  OS_ENTER_CRITICAL();
+  os_event_t *event = &os_ctx.events[id];
+  if (event->type != OS_EVENT_MSGQ) {
     OS_EXIT_CRITICAL();
+    return OS_WRONG_EVENT;
   }
-  switch (os_curr_task->wait_return) {
-  case OS_WAIT_RET_OK:
+  /* only receivers wait on an empty queue */
+  os_tcb_t *receiver = (event->count == 0) ? _wait_get_next(event) : OS_NULL;
+  if (receiver != OS_NULL) {
+    _msg_copy(receiver->msg, msg, event->data.msgq.msg_size);
+    _wake_up(receiver, event);
+    OS_EXIT_CRITICAL();
+    os_schedule();
+    return OS_OK;
+  }
+  if (event->count < event->data.msgq.depth) {
+    _msgq_push(event, msg, to_front);
+    OS_EXIT_CRITICAL();
     return OS_OK;
-  case OS_WAIT_RET_TIMEOUT:
-    return OS_TIMEOUT;
-  default:
-    return OS_ERROR;
   }
+  if (!can_wait) {
+    OS_EXIT_CRITICAL();
+    return OS_QUEUE_FULL;
+  }
+  os_curr_task->msg = (void *)msg;
+  os_curr_task->msg_to_front = to_front;
+  _wait_for_event(event, timeout);
+  OS_EXIT_CRITICAL();
+  os_schedule();
+  return _wait_result();
 }
 
-os_error_t os_mutex_give(os_event_id_t id) {
+void os_msgq_init(os_event_id_t id, os_u8_t *buffer, os_size_t msg_size,
+                  os_size_t depth) {
+  OS_ASSERT((buffer != OS_NULL) && (msg_size != 0) && (depth != 0),
+            OS_NULL_PARAM);
+  os_event_init(id, OS_EVENT_MSGQ, 0);
+  os_ctx.events[id].data.msgq.buffer = buffer;
+  os_ctx.events[id].data.msgq.msg_size = msg_size;
+  os_ctx.events[id].data.msgq.depth = depth;
+  os_ctx.events[id].data.msgq.head = 0;
+}
+
+os_error_t os_msgq_send(os_event_id_t id, const void *msg, os_size_t timeout) {
+  return _msgq_send(id, msg, timeout, OS_FALSE, OS_TRUE);
+}
+
+os_error_t os_msgq_send_to_front(os_event_id_t id, const void *msg,
+                                 os_size_t timeout) {
+  return _msgq_send(id, msg, timeout, OS_TRUE, OS_TRUE);
+}
+
+os_error_t os_msgq_post(os_event_id_t id, const void *msg) {
+  return _msgq_send(id, msg, 0, OS_FALSE, OS_FALSE);
+}
+
+os_error_t os_msgq_receive(os_event_id_t id, void *msg, os_size_t timeout) {
   OS_DECLARE_CRITICAL();
   OS_ENTER_CRITICAL();
-  if (os_ctx.events[id].type != OS_EVENT_MUTEX) {
+  os_event_t *event = &os_ctx.events[id];
+  if (event->type != OS_EVENT_MSGQ) {
     OS_EXIT_CRITICAL();
     return OS_WRONG_EVENT;
   }
-  if (os_curr_task->curr_prio != os_curr_task->base_prio) {
-    os_queue_remove(os_curr_task, &os_ctx.priorities[os_curr_task->curr_prio]);
-    OS_PRIORITY_UNREADY(os_curr_task->curr_prio);
-    os_curr_task->curr_prio = os_curr_task->base_prio;
-    os_queue_push(os_curr_task, &os_ctx.priorities[os_curr_task->curr_prio]);
-    OS_PRIORITY_READY(os_curr_task->curr_prio);
+  if (event->count != 0) {
+    _msgq_pop(event, msg);
+    /* only senders wait on a non-empty queue */
+    os_tcb_t *sender = _wait_get_next(event);
+    if (sender != OS_NULL) {
+      _msgq_push(event, sender->msg, sender->msg_to_front);
+      _wake_up(sender, event);
+      OS_EXIT_CRITICAL();
+      os_schedule();
+    } else {
+      OS_EXIT_CRITICAL();
+    }
+    return OS_OK;
   }
-  os_tcb_t *high_prio_task = _mutex_get_next(&os_ctx.events[id]);
-  if (high_prio_task != OS_NULL) {
-    os_ctx.events[id].holder = high_prio_task;
-    os_queue_remove(high_prio_task, &os_ctx.events[id].queue);
-    os_ctx.events[id].holder->state = OS_TASK_READY;
-    os_ctx.events[id].holder->delay = 0;
-    os_queue_push(os_ctx.events[id].holder,
-                  &os_ctx.priorities[os_ctx.events[id].holder->curr_prio]);
-    OS_PRIORITY_READY(os_ctx.events[id].holder->curr_prio);
+  os_curr_task->msg = msg;
+  _wait_for_event(event, timeout);
+  OS_EXIT_CRITICAL();
+  os_schedule();
+  return _wait_result();
+}
+
+os_error_t os_msgq_send_ptr(os_event_id_t id, void *ptr, os_size_t timeout) {
+  if (os_ctx.events[id].data.msgq.msg_size != sizeof(void *)) {
+    return OS_WRONG_EVENT;
+  }
+  return os_msgq_send(id, &ptr, timeout);
+}
+
+os_error_t os_msgq_receive_ptr(os_event_id_t id, void **ptr,
+                               os_size_t timeout) {
+  if (os_ctx.events[id].data.msgq.msg_size != sizeof(void *)) {
+    return OS_WRONG_EVENT;
+  }
+  return os_msgq_receive(id, ptr, timeout);
+}
+#endif /* if OS_CFG_ENABLE_MESSAGE_QUEUES */
+
+#if OS_CFG_ENABLE_RING_BUFFERS
+/**
+ * @brief   Wakes up the consumer of a ring buffer, if it's still waiting.
+ */
+static void _ring_wake(os_event_t *event) {
+  OS_DECLARE_CRITICAL();
+  OS_ENTER_CRITICAL();
+  if (!event->data.ring.armed) {
+    OS_EXIT_CRITICAL();
+    return;
+  }
+  event->data.ring.armed = OS_FALSE;
+  os_tcb_t *consumer = _wait_get_next(event);
+  if (consumer != OS_NULL) {
+    _wake_up(consumer, event);
     OS_EXIT_CRITICAL();
     os_schedule();
   } else {
-    os_ctx.events[id].holder = OS_NULL;
     OS_EXIT_CRITICAL();
   }
-  return OS_OK;
 }
 
-os_error_t os_semaphore_take(os_event_id_t id, os_size_t timeout) {
+void os_ring_init(os_event_id_t id, os_u8_t *buffer, os_size_t record_size,
+                  os_size_t depth, os_size_t wake_level) {
+  OS_ASSERT((buffer != OS_NULL) && (record_size != 0) && (depth != 0),
+            OS_NULL_PARAM);
+  os_event_init(id, OS_EVENT_RING, 0);
+  os_ctx.events[id].data.ring.buffer = buffer;
+  os_ctx.events[id].data.ring.record_size = record_size;
+  os_ctx.events[id].data.ring.depth = depth;
+  os_ctx.events[id].data.ring.wake_level = (wake_level != 0) ? wake_level : 1;
+}
+
+os_size_t os_ring_write(os_event_id_t id, const void *data, os_size_t count) {
+  os_event_t *event = &os_ctx.events[id];
+  os_ring_t *ring = &event->data.ring;
+  if (event->type != OS_EVENT_RING) {
+    return 0;
+  }
+  os_size_t head = ring->head;
+  os_size_t space = ring->depth - (head - ring->tail);
+  if (count > space) {
+    count = space;
+  }
+  os_size_t slot = head & (ring->depth - 1);
+  os_size_t first = ring->depth - slot;
+  if (first > count) {
+    first = count;
+  }
+  _msg_copy(&ring->buffer[slot * ring->record_size], data,
+            first * ring->record_size);
+  _msg_copy(ring->buffer, (const os_u8_t *)data + first * ring->record_size,
+            (count - first) * ring->record_size);
+  /* publish the records before the head, and the head before reading armed */
+  OS_MEMORY_BARRIER();
+  ring->head = head + count;
+  OS_MEMORY_BARRIER();
+  if (ring->armed && ((ring->head - ring->tail) >= ring->wake_level)) {
+    _ring_wake(event);
+  }
+  return count;
+}
+
+os_size_t os_ring_read(os_event_id_t id, void *data, os_size_t count) {
+  os_event_t *event = &os_ctx.events[id];
+  os_ring_t *ring = &event->data.ring;
+  if (event->type != OS_EVENT_RING) {
+    return 0;
+  }
+  os_size_t tail = ring->tail;
+  os_size_t available = ring->head - tail;
+  /* read the head before the records */
+  OS_MEMORY_BARRIER();
+  if (count > available) {
+    count = available;
+  }
+  os_size_t slot = tail & (ring->depth - 1);
+  os_size_t first = ring->depth - slot;
+  if (first > count) {
+    first = count;
+  }
+  _msg_copy(data, &ring->buffer[slot * ring->record_size],
+            first * ring->record_size);
+  _msg_copy((os_u8_t *)data + first * ring->record_size, ring->buffer,
+            (count - first) * ring->record_size);
+  /* release the slots only after they were copied */
+  OS_MEMORY_BARRIER();
+  ring->tail = tail + count;
+  return count;
+}
+
+os_size_t os_ring_count(os_event_id_t id) {
+  const os_ring_t *ring = &os_ctx.events[id].data.ring;
+  return ring->head - ring->tail;
+}
+
+os_error_t os_ring_wait(os_event_id_t id, os_size_t timeout) {
   OS_DECLARE_CRITICAL();
   OS_ENTER_CRITICAL();
-  if (os_ctx.events[id].type != OS_EVENT_SEMAPHORE) {
+  os_event_t *event = &os_ctx.events[id];
+  os_ring_t *ring = &event->data.ring;
+  if (event->type != OS_EVENT_RING) {
     OS_EXIT_CRITICAL();
     return OS_WRONG_EVENT;
   }
-  os_curr_task->wait_return = OS_WAIT_RET_OK;
-  if (os_ctx.events[id].count == 0) {
-    os_curr_task->state = OS_TASK_WAITING_FOR_EVENT;
-    os_curr_task->delay = timeout;
-    os_curr_task->wait_event = &os_ctx.events[id];
-    os_queue_pop(&os_ctx.priorities[os_curr_task->curr_prio]);
-    OS_PRIORITY_UNREADY(os_curr_task->curr_prio);
-    os_queue_push(os_curr_task, &os_ctx.events[id].queue);
+  if ((ring->head - ring->tail) >= ring->wake_level) {
+    OS_EXIT_CRITICAL();
+    return OS_OK;
+  }
+  ring->armed = OS_TRUE;
+  _wait_for_event(event, timeout);
+  OS_EXIT_CRITICAL();
+  os_schedule();
+  ring->armed = OS_FALSE;
+  return _wait_result();
+}
+#endif /* if OS_CFG_ENABLE_RING_BUFFERS */
+
+#if OS_CFG_ENABLE_EVENT_FLAGS
+/**
+ * @brief   Checks if a wait condition is met.
+ */
+static os_bool_t _flags_match(os_flags_t flags, os_flags_t mask,
+                              os_flags_opt_t options) {
+  if (options & OS_FLAGS_WAIT_ALL) {
+    return (flags & mask) == mask;
+  }
+  return (flags & mask) != 0;
+}
+
+os_error_t os_flags_set(os_event_id_t id, os_flags_t mask) {
+  OS_DECLARE_CRITICAL();
+  OS_ENTER_CRITICAL();
+  os_event_t *event = &os_ctx.events[id];
+  if (event->type != OS_EVENT_FLAGS) {
     OS_EXIT_CRITICAL();
+    return OS_WRONG_EVENT;
+  }
+  event->count |= mask;
+  os_bool_t woken = OS_FALSE;
+  /* waiters are evaluated from the highest priority, so they're the first
+   * to consume flags cleared on exit */
+  os_tcb_t *task = event->waiting.first;
+  while (task != OS_NULL) {
+    os_tcb_t *next = task->next;
+    if (_flags_match(event->count, task->flags, task->flags_options)) {
+      os_flags_t mask_to_clear = task->flags;
+      task->flags = event->count;
+      if (task->flags_options & OS_FLAGS_CLEAR_ON_EXIT) {
+        event->count &= ~mask_to_clear;
+      }
+      _wake_up(task, event);
+      woken = OS_TRUE;
+    }
+    task = next;
+  }
+  OS_EXIT_CRITICAL();
+  if (woken) {
     os_schedule();
-  } else {
-    os_ctx.events[id].count--;
+  }
+  return OS_OK;
+}
+
+os_error_t os_flags_clear(os_event_id_t id, os_flags_t mask) {
+  OS_DECLARE_CRITICAL();
+  OS_ENTER_CRITICAL();
+  if (os_ctx.events[id].type != OS_EVENT_FLAGS) {
     OS_EXIT_CRITICAL();
+    return OS_WRONG_EVENT;
   }
-  switch (os_curr_task->wait_return) {
-  case OS_WAIT_RET_OK:
+  os_ctx.events[id].count &= ~mask;
+  OS_EXIT_CRITICAL();
+  return OS_OK;
+}
+
+os_flags_t os_flags_get(os_event_id_t id) { return os_ctx.events[id].count; }
+
+os_error_t os_flags_wait(os_event_id_t id, os_flags_t mask,
+                         os_flags_opt_t options, os_size_t timeout,
+                         os_flags_t *flags) {
+  OS_DECLARE_CRITICAL();
+  OS_ENTER_CRITICAL();
+  os_event_t *event = &os_ctx.events[id];
+  if (event->type != OS_EVENT_FLAGS) {
+    OS_EXIT_CRITICAL();
+    return OS_WRONG_EVENT;
+  }
+  if (mask == 0) {
+    OS_EXIT_CRITICAL();
+    return OS_NULL_PARAM;
+  }
+  if (_flags_match(event->count, mask, options)) {
+    if (flags != OS_NULL) {
+      *flags = event->count;
+    }
+    if (options & OS_FLAGS_CLEAR_ON_EXIT) {
+      event->count &= ~mask;
+    }
+    OS_EXIT_CRITICAL();
     return OS_OK;
-  case OS_WAIT_RET_TIMEOUT:
-    return OS_TIMEOUT;
-  default:
-    return OS_ERROR;
   }
+  os_curr_task->flags = mask;
+  os_curr_task->flags_options = options;
+  _wait_for_event(event, timeout);
+  OS_EXIT_CRITICAL();
+  os_schedule();
+  os_error_t ret = _wait_result();
+  if ((ret == OS_OK) && (flags != OS_NULL)) {
+    *flags = os_curr_task->flags;
+  }
+  return ret;
 }
+#endif /* if OS_CFG_ENABLE_EVENT_FLAGS */
 
-os_error_t os_semaphore_give(os_event_id_t id) {
+#if OS_CFG_ENABLE_MEMORY_POOLS
+/**
+ * @brief   Takes the first free block of a non-empty pool.
+ * @note    Call this from within a critical section.
+ */
+static void *_pool_take(os_event_t *event) {
+  os_pool_t *pool = &event->data.pool;
+  void *block = pool->free;
+  pool->free = *(void **)block;
+  event->count--;
+  if (pool->block_cnt - event->count > pool->used_max) {
+    pool->used_max = pool->block_cnt - event->count;
+  }
+  return block;
+}
+
+void os_pool_init(os_event_id_t id, void **buffer, os_size_t block_words,
+                  os_size_t block_cnt) {
+  OS_ASSERT((buffer != OS_NULL) && (block_words != 0) && (block_cnt != 0),
+            OS_NULL_PARAM);
+  os_event_init(id, OS_EVENT_POOL, block_cnt);
+  os_pool_t *pool = &os_ctx.events[id].data.pool;
+  pool->buffer = (os_u8_t *)buffer;
+  pool->block_size = block_words * sizeof(void *);
+  pool->block_cnt = block_cnt;
+  pool->used_max = 0;
+  pool->free = OS_NULL;
+  for (os_size_t i = block_cnt; i > 0; i--) {
+    void **block = &buffer[(i - 1) * block_words];
+    *block = pool->free;
+    pool->free = block;
+  }
+}
+
+os_error_t os_pool_alloc(os_event_id_t id, void **block, os_size_t timeout) {
   OS_DECLARE_CRITICAL();
+  if (block == OS_NULL) {
+    return OS_NULL_PARAM;
+  }
   OS_ENTER_CRITICAL();
-  if (os_ctx.events[id].type != OS_EVENT_SEMAPHORE) {
+  os_event_t *event = &os_ctx.events[id];
+  if (event->type != OS_EVENT_POOL) {
     OS_EXIT_CRITICAL();
     return OS_WRONG_EVENT;
   }
-  os_ctx.events[id].count++;
-  os_tcb_t *next = os_ctx.events[id].queue.first;
-  if (next != OS_NULL) {
-    next->state = OS_TASK_READY;
-    next->delay = 0;
-    os_queue_pop(&os_ctx.events[id].queue);
-    os_queue_push(next, &os_ctx.priorities[next->curr_prio]);
-    OS_PRIORITY_READY(next->curr_prio);
+  if (event->count != 0) {
+    *block = _pool_take(event);
+    OS_EXIT_CRITICAL();
+    return OS_OK;
+  }
+  _wait_for_event(event, timeout);
+  OS_EXIT_CRITICAL();
+  os_schedule();
+  os_error_t ret = _wait_result();
+  if (ret == OS_OK) {
+    *block = os_curr_task->block;
+  }
+  return ret;
+}
+
+void *os_pool_try_alloc(os_event_id_t id) {
+  OS_DECLARE_CRITICAL();
+  void *block = OS_NULL;
+  OS_ENTER_CRITICAL();
+  os_event_t *event = &os_ctx.events[id];
+  if ((event->type == OS_EVENT_POOL) && (event->count != 0)) {
+    block = _pool_take(event);
+  }
+  OS_EXIT_CRITICAL();
+  return block;
+}
+
+os_error_t os_pool_free(os_event_id_t id, void *block) {
+  OS_DECLARE_CRITICAL();
+  os_event_t *event = &os_ctx.events[id];
+  if (block == OS_NULL) {
+    return OS_NULL_PARAM;
+  }
+  if (event->type != OS_EVENT_POOL) {
+    return OS_WRONG_EVENT;
+  }
+  os_size_t offset = (os_size_t)((os_u8_t *)block - event->data.pool.buffer);
+  if (((os_u8_t *)block < event->data.pool.buffer) ||
+      (offset >= event->data.pool.block_size * event->data.pool.block_cnt) ||
+      ((offset % event->data.pool.block_size) != 0)) {
+    return OS_ERROR;
+  }
+  OS_ENTER_CRITICAL();
+  /* tasks only wait on an exhausted pool */
+  os_tcb_t *task = _wait_get_next(event);
+  if (task != OS_NULL) {
+    task->block = block;
+    _wake_up(task, event);
     OS_EXIT_CRITICAL();
     os_schedule();
-  } else {
+    return OS_OK;
+  }
+  *(void **)block = event->data.pool.free;
+  event->data.pool.free = block;
+  event->count++;
+  OS_EXIT_CRITICAL();
+  return OS_OK;
+}
+
+os_error_t os_pool_get_stats(os_event_id_t id, os_pool_stats_t *stats) {
+  OS_DECLARE_CRITICAL();
+  if (stats == OS_NULL) {
+    return OS_NULL_PARAM;
+  }
+  OS_ENTER_CRITICAL();
+  os_event_t *event = &os_ctx.events[id];
+  if (event->type != OS_EVENT_POOL) {
     OS_EXIT_CRITICAL();
+    return OS_WRONG_EVENT;
   }
+  stats->block_size = event->data.pool.block_size;
+  stats->block_cnt = event->data.pool.block_cnt;
+  stats->used = event->data.pool.block_cnt - event->count;
+  stats->used_max = event->data.pool.used_max;
+  OS_EXIT_CRITICAL();
   return OS_OK;
 }
+#endif /* if OS_CFG_ENABLE_MEMORY_POOLS */
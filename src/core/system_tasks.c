@@ -1,4 +1,4 @@
-#include "seal.h"
+#include "private.h"
 
 /**
  * @brief       This is the system idle task.
@@ -6,6 +6,23 @@
  */
 void idle_entry(void *param) {
   OS_UNUSED(param);
+#if OS_CFG_STACK_FILL == OS_STACK_FILL_IDLE
+  os_stack_fill();
+#endif
   while (1) {
+#if OS_CFG_ENABLE_TICKLESS_IDLE
+    os_port_tickless_idle();
+#endif
   }
 }
+
+#if OS_CFG_ENABLE_TIMERS
+/**
+ * @brief       This is the timer service task, it runs the callbacks of
+ *              expired timers.
+ */
+void timer_entry(void *param) {
+  OS_UNUSED(param);
+  os_timer_service();
+}
+#endif
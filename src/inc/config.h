@@ -4,10 +4,42 @@
 extern "C" {
 #endif
 
+/**
+ * @brief   Define OS_CFG_APP_DEFINITIONS as a header name, e.g.
+ *          -DOS_CFG_APP_DEFINITIONS=\"bench_config.h\", to replace the
+ *          object definitions and OS_CFG_* switches below with your own.
+ */
+/**
+ * @brief   Values of OS_CFG_STACK_FILL.
+ */
+#define OS_STACK_FILL_NONE 0U
+#define OS_STACK_FILL_BOOT 1U
+#define OS_STACK_FILL_IDLE 2U
+
+#ifdef OS_CFG_APP_DEFINITIONS
+#include OS_CFG_APP_DEFINITIONS
+#else
+
 #define OS_MUTEX_DEFINITIONS OS_MUTEX(OS_MUTEX_ID_FOO)
 
 #define OS_SEMAPHORE_DEFINITIONS OS_SEMAPHORE(OS_SEMAPHORE_ID_FOO, 2)
 
+/**
+ * @brief   Timers expire in the context of a timer service task. Add it to
+ *          OS_TASK_DEFINITIONS with timer_entry as the entry function and a
+ *          priority above the tasks the callbacks serve.
+ *
+ *  _id,        - Id of the timer.
+ *  _period,    - Period [in systicks], it's also the first delay of an
+ *                autostarted timer.
+ *  _options,   - OS_TIMER_ONE_SHOT or OS_TIMER_PERIODIC, optionally combined
+ *                with OS_TIMER_AUTOSTART and OS_TIMER_IN_ISR.
+ *  _callback,  - Name of the callback function.
+ *  _param      - Pointer to the callback function parameter.
+ */
+#define OS_TIMER_DEFINITIONS                                                   \
+  OS_TIMER(OS_TIMER_ID_FOO, 100, OS_TIMER_PERIODIC, foo_callback, OS_NULL)
+
 /**
  * @brief   This macro is used to create all structures required by the tasks.
  * @warning The task with the highest priority should appear last on the list.
@@ -22,12 +54,151 @@ extern "C" {
  *                       Note that it will be rounded down to a multiple
  *                       of sizeof(os_stack_t).
  *  _entry_func,       - Name of the entry function.
- *  _entry_func_param  - Pointer to the entry function parameter.
+ *  _entry_func_param, - Pointer to the entry function parameter.
+ *  _quantum           - Time slice of the task [in systicks], 0 selects
+ *                       OS_CFG_TIME_SLICE_QUANTUM. It's only used with
+ *                       OS_CFG_ENABLE_TIME_SLICING.
  */
 #define OS_TASK_DEFINITIONS                                                    \
-  OS_TASK(OS_TASK_ID_IDLE, 0, 512, idle_entry, OS_NULL)                        \
-  OS_TASK(OS_TASK_ID_LED, 1, 512, led_entry, OS_NULL)                          \
-  OS_TASK(OS_TASK_ID_PRINT, 1, 512, print_entry, OS_NULL)
+  OS_TASK(OS_TASK_ID_IDLE, 0, 512, idle_entry, OS_NULL, 0)                     \
+  OS_TASK(OS_TASK_ID_LED, 1, 512, led_entry, OS_NULL, 0)                       \
+  OS_TASK(OS_TASK_ID_PRINT, 1, 512, print_entry, OS_NULL, 0)
+
+#define OS_CFG_ENABLE_STATS 0U
+#define OS_CFG_ENABLE_MESSAGE_QUEUES 0U
+#define OS_CFG_ENABLE_MUTEXES 0U
+#define OS_CFG_ENABLE_SEMAPHORES 0U
+#define OS_CFG_ENABLE_TICKLESS_IDLE 0U
+#define OS_CFG_ENABLE_RING_BUFFERS 0U
+#define OS_CFG_ENABLE_EVENT_FLAGS 0U
+#define OS_CFG_ENABLE_ISR_POSTS 0U
+
+/**
+ * @brief Capacity of the deferred ISR post queue. It needs to be a power of
+ * two.
+ */
+#define OS_CFG_ISR_POST_QUEUE_DEPTH 16U
+#define OS_CFG_ENABLE_MEMORY_POOLS 0U
+#define OS_CFG_ENABLE_TRACE 0U
+
+/**
+ * @brief Capacity of the trace buffer [in records]. It needs to be a power of
+ * two. Each record takes 8 bytes.
+ */
+#define OS_CFG_TRACE_BUFFER_DEPTH 256U
+#define OS_CFG_ENABLE_TIME_SLICING 0U
+
+/**
+ * @brief Default time slice [in systicks] after which a running task yields to
+ * the other ready tasks of its priority.
+ */
+#define OS_CFG_TIME_SLICE_QUANTUM 10U
+#define OS_CFG_ENABLE_TIMERS 0U
+
+/**
+ * @brief Fills the task stacks with a pattern that the stack high-water mark is
+ * measured against. OS_STACK_FILL_BOOT does it in os_init(), so the boot time
+ * grows with the total stack size. OS_STACK_FILL_IDLE only fills the stacks of
+ * priority 0 tasks there and leaves the rest to the idle task, which fills the
+ * unused part of each stack in short critical sections. OS_STACK_FILL_NONE
+ * skips it.
+ */
+#define OS_CFG_STACK_FILL OS_STACK_FILL_BOOT
+#define OS_CFG_ENABLE_TASK_NOTIFICATIONS 0U
+
+/**
+ * @brief Records how long each OS_ENTER_CRITICAL() call site keeps interrupts
+ * masked, see os_critical_profile_dump(). It reads the cycle counter twice per
+ * outermost critical section, so it's meant for profiling builds.
+ */
+#define OS_CFG_ENABLE_CRITICAL_PROFILER 0U
+
+/**
+ * @brief Places a no-access MPU region at the bottom of the running task's
+ * stack, so that an overflow faults right away. The port's MemManage handler
+ * then panics with OS_STACK_OVERFLOW, see os_task_get_id(). Each stack grows
+ * by the size of the guard and gets aligned to it.
+ */
+#define OS_CFG_ENABLE_STACK_GUARD 0U
+
+/**
+ * @brief Enables os_task_create(), which takes a TCB and a stack from a pool
+ * of OS_CFG_DYNAMIC_TASK_CNT slots. os_task_delete() and returning from the
+ * entry function put them back. The task ids of the slots follow
+ * OS_TASK_ID_CNT.
+ */
+#define OS_CFG_ENABLE_DYNAMIC_TASKS 0U
+#define OS_CFG_DYNAMIC_TASK_CNT 4U
+
+/**
+ * @brief Stack size of each dynamic task [in bytes].
+ */
+#define OS_CFG_DYNAMIC_TASK_STACK_SIZE 512U
+
+/**
+ * @brief Enables reader-writer locks, see os_rwlock_read_take(). Each lock
+ * keeps track of up to OS_CFG_RWLOCK_READER_CNT readers, so that a waiting
+ * writer can raise their priorities. Further readers wait for a free slot.
+ */
+#define OS_CFG_ENABLE_RWLOCKS 0U
+#define OS_CFG_RWLOCK_READER_CNT 4U
+
+/**
+ *  _id,       - Id of the message queue.
+ *  _msg_size, - Size of a single message [in bytes].
+ *  _depth     - Maximum amount of queued messages.
+ */
+#if OS_CFG_ENABLE_MESSAGE_QUEUES
+#define OS_MSGQ_DEFINITIONS OS_MSGQ(OS_MSGQ_ID_FOO, 4, 8)
+#else
+#define OS_MSGQ_DEFINITIONS
+#endif
+
+/**
+ *  _id,          - Id of the ring buffer.
+ *  _record_size, - Size of a single record [in bytes], 1 for byte streams.
+ *  _depth,       - Capacity [in records]. It needs to be a power of two.
+ *  _wake_level   - Amount of records that wakes up the consumer waiting in
+ *                  os_ring_wait().
+ */
+#if OS_CFG_ENABLE_RING_BUFFERS
+#define OS_RING_DEFINITIONS OS_RING(OS_RING_ID_FOO, 1, 64, 16)
+#else
+#define OS_RING_DEFINITIONS
+#endif
+
+/**
+ *  _id,      - Id of the event flag group.
+ *  _initial  - Initial value of the flags.
+ */
+#if OS_CFG_ENABLE_EVENT_FLAGS
+#define OS_FLAGS_DEFINITIONS OS_FLAGS(OS_FLAGS_ID_FOO, 0)
+#else
+#define OS_FLAGS_DEFINITIONS
+#endif
+
+/**
+ *  _id,          - Id of the memory pool.
+ *  _block_size,  - Size of a single block [in bytes]. It's rounded up to a
+ *                  multiple of sizeof(void *).
+ *  _block_cnt    - Amount of blocks in the pool.
+ */
+#if OS_CFG_ENABLE_MEMORY_POOLS
+#define OS_POOL_DEFINITIONS OS_POOL(OS_POOL_ID_FOO, 32, 8)
+#else
+#define OS_POOL_DEFINITIONS
+#endif
+
+/**
+ *  _id - Id of the reader-writer lock.
+ */
+#if OS_CFG_ENABLE_RWLOCKS
+#define OS_RWLOCK_DEFINITIONS OS_RWLOCK(OS_RWLOCK_ID_FOO)
+#else
+#define OS_RWLOCK_DEFINITIONS
+#endif
+
+#endif /* ifdef OS_CFG_APP_DEFINITIONS */
 
 typedef enum {
 #define OS_MUTEX(_id) _id,
@@ -36,20 +207,49 @@ typedef enum {
 #define OS_SEMAPHORE(_id, _count) _id,
       OS_SEMAPHORE_DEFINITIONS
 #undef OS_SEMAPHORE
+#define OS_MSGQ(_id, _msg_size, _depth) _id,
+          OS_MSGQ_DEFINITIONS
+#undef OS_MSGQ
+#define OS_RING(_id, _record_size, _depth, _wake_level) _id,
+              OS_RING_DEFINITIONS
+#undef OS_RING
+#define OS_FLAGS(_id, _initial) _id,
+                  OS_FLAGS_DEFINITIONS
+#undef OS_FLAGS
+#define OS_POOL(_id, _block_size, _block_cnt) _id,
+                      OS_POOL_DEFINITIONS
+#undef OS_POOL
+#define OS_RWLOCK(_id) _id,
+                          OS_RWLOCK_DEFINITIONS
+#undef OS_RWLOCK
           OS_EVENT_ID_CNT,
 } os_event_id_t;
 
-#define OS_TASK(_id, _priority, _stack_size, _entry_func, _entry_func_param)   \
+#define OS_TASK(_id, _priority, _stack_size, _entry_func, _entry_func_param,   \
+                _quantum)                                                      \
   void _entry_func(void *);
 OS_TASK_DEFINITIONS
 #undef OS_TASK
 
+#define OS_TIMER(_id, _period, _options, _callback, _param)                    \
+  void _callback(void *);
+OS_TIMER_DEFINITIONS
+#undef OS_TIMER
+
+typedef enum {
+#define OS_TIMER(_id, _period, _options, _callback, _param) _id,
+  OS_TIMER_DEFINITIONS
+#undef OS_TIMER
+      OS_TIMER_ID_CNT,
+} os_timer_id_t;
+
 /**
  * @brief This enum is used for inter-task communication. Example member:
  * OS_TASK_ID_IDLE
  */
 typedef enum {
-#define OS_TASK(_id, _priority, _stack_size, _entry_func, _entry_func_param)   \
+#define OS_TASK(_id, _priority, _stack_size, _entry_func, _entry_func_param,   \
+                _quantum)                                                      \
   _id,
   OS_TASK_DEFINITIONS
 #undef OS_TASK
@@ -60,18 +260,14 @@ typedef enum {
  * @brief This enum is used to calculate the amount of priority levels.
  */
 typedef enum {
-#define OS_TASK(_id, _priority, _stack_size, _entry_func, _entry_func_param)   \
+#define OS_TASK(_id, _priority, _stack_size, _entry_func, _entry_func_param,   \
+                _quantum)                                                      \
   OS_PRIORITY_LEVEL_##_id = _priority,
   OS_TASK_DEFINITIONS
 #undef OS_TASK
       OS_PRIORITY_LEVEL_CNT,
 } os_priority_level_t;
 
-#define OS_CFG_ENABLE_STATS 0U
-#define OS_CFG_ENABLE_MESSAGE_QUEUES 0U
-#define OS_CFG_ENABLE_MUTEXES 0U
-#define OS_CFG_ENABLE_SEMAPHORES 0U
-
 #ifndef OS_CFG_ENABLE_STATS
 #error OS_CFG_ENABLE_STATS must be defined!
 #else
@@ -104,6 +300,171 @@ typedef enum {
 #endif
 #endif
 
+#ifndef OS_CFG_ENABLE_TICKLESS_IDLE
+#error OS_CFG_ENABLE_TICKLESS_IDLE must be defined!
+#else
+#if (OS_CFG_ENABLE_TICKLESS_IDLE != 1U) && (OS_CFG_ENABLE_TICKLESS_IDLE != 0U)
+#error OS_CFG_ENABLE_TICKLESS_IDLE needs to be either 1U or 0U!
+#endif
+#endif
+
+#ifndef OS_CFG_ENABLE_RING_BUFFERS
+#error OS_CFG_ENABLE_RING_BUFFERS must be defined!
+#else
+#if (OS_CFG_ENABLE_RING_BUFFERS != 1U) && (OS_CFG_ENABLE_RING_BUFFERS != 0U)
+#error OS_CFG_ENABLE_RING_BUFFERS needs to be either 1U or 0U!
+#endif
+#endif
+
+#ifndef OS_CFG_ENABLE_EVENT_FLAGS
+#error OS_CFG_ENABLE_EVENT_FLAGS must be defined!
+#else
+#if (OS_CFG_ENABLE_EVENT_FLAGS != 1U) && (OS_CFG_ENABLE_EVENT_FLAGS != 0U)
+#error OS_CFG_ENABLE_EVENT_FLAGS needs to be either 1U or 0U!
+#endif
+#endif
+
+#ifndef OS_CFG_ENABLE_ISR_POSTS
+#error OS_CFG_ENABLE_ISR_POSTS must be defined!
+#else
+#if (OS_CFG_ENABLE_ISR_POSTS != 1U) && (OS_CFG_ENABLE_ISR_POSTS != 0U)
+#error OS_CFG_ENABLE_ISR_POSTS needs to be either 1U or 0U!
+#endif
+#endif
+
+#if OS_CFG_ENABLE_ISR_POSTS
+#ifndef OS_CFG_ISR_POST_QUEUE_DEPTH
+#error OS_CFG_ISR_POST_QUEUE_DEPTH must be defined!
+#elif (OS_CFG_ISR_POST_QUEUE_DEPTH == 0U) ||                                   \
+    ((OS_CFG_ISR_POST_QUEUE_DEPTH & (OS_CFG_ISR_POST_QUEUE_DEPTH - 1U)) != 0U)
+#error OS_CFG_ISR_POST_QUEUE_DEPTH needs to be a power of two!
+#endif
+#endif
+
+#ifndef OS_CFG_ENABLE_MEMORY_POOLS
+#error OS_CFG_ENABLE_MEMORY_POOLS must be defined!
+#else
+#if (OS_CFG_ENABLE_MEMORY_POOLS != 1U) && (OS_CFG_ENABLE_MEMORY_POOLS != 0U)
+#error OS_CFG_ENABLE_MEMORY_POOLS needs to be either 1U or 0U!
+#endif
+#endif
+
+#ifndef OS_CFG_ENABLE_TRACE
+#error OS_CFG_ENABLE_TRACE must be defined!
+#else
+#if (OS_CFG_ENABLE_TRACE != 1U) && (OS_CFG_ENABLE_TRACE != 0U)
+#error OS_CFG_ENABLE_TRACE needs to be either 1U or 0U!
+#endif
+#endif
+
+#if OS_CFG_ENABLE_TRACE
+#ifndef OS_CFG_TRACE_BUFFER_DEPTH
+#error OS_CFG_TRACE_BUFFER_DEPTH must be defined!
+#elif (OS_CFG_TRACE_BUFFER_DEPTH == 0U) ||                                     \
+    ((OS_CFG_TRACE_BUFFER_DEPTH & (OS_CFG_TRACE_BUFFER_DEPTH - 1U)) != 0U)
+#error OS_CFG_TRACE_BUFFER_DEPTH needs to be a power of two!
+#endif
+#endif
+
+#ifndef OS_CFG_ENABLE_TIME_SLICING
+#error OS_CFG_ENABLE_TIME_SLICING must be defined!
+#else
+#if (OS_CFG_ENABLE_TIME_SLICING != 1U) && (OS_CFG_ENABLE_TIME_SLICING != 0U)
+#error OS_CFG_ENABLE_TIME_SLICING needs to be either 1U or 0U!
+#endif
+#endif
+
+#if OS_CFG_ENABLE_TIME_SLICING
+#ifndef OS_CFG_TIME_SLICE_QUANTUM
+#error OS_CFG_TIME_SLICE_QUANTUM must be defined!
+#elif OS_CFG_TIME_SLICE_QUANTUM == 0U
+#error OS_CFG_TIME_SLICE_QUANTUM needs to be greater than 0!
+#endif
+#endif
+
+#ifndef OS_CFG_ENABLE_TIMERS
+#error OS_CFG_ENABLE_TIMERS must be defined!
+#else
+#if (OS_CFG_ENABLE_TIMERS != 1U) && (OS_CFG_ENABLE_TIMERS != 0U)
+#error OS_CFG_ENABLE_TIMERS needs to be either 1U or 0U!
+#endif
+#endif
+
+#ifndef OS_CFG_STACK_FILL
+#error OS_CFG_STACK_FILL must be defined!
+#elif (OS_CFG_STACK_FILL != OS_STACK_FILL_NONE) &&                             \
+    (OS_CFG_STACK_FILL != OS_STACK_FILL_BOOT) &&                               \
+    (OS_CFG_STACK_FILL != OS_STACK_FILL_IDLE)
+#error OS_CFG_STACK_FILL needs to be one of OS_STACK_FILL_NONE, _BOOT or _IDLE!
+#elif OS_CFG_ENABLE_STATS && (OS_CFG_STACK_FILL == OS_STACK_FILL_NONE)
+#error OS_CFG_ENABLE_STATS needs OS_CFG_STACK_FILL to fill the stacks!
+#endif
+
+#ifndef OS_CFG_ENABLE_TASK_NOTIFICATIONS
+#error OS_CFG_ENABLE_TASK_NOTIFICATIONS must be defined!
+#else
+#if (OS_CFG_ENABLE_TASK_NOTIFICATIONS != 1U) &&                                \
+    (OS_CFG_ENABLE_TASK_NOTIFICATIONS != 0U)
+#error OS_CFG_ENABLE_TASK_NOTIFICATIONS needs to be either 1U or 0U!
+#endif
+#endif
+
+#ifndef OS_CFG_ENABLE_CRITICAL_PROFILER
+#error OS_CFG_ENABLE_CRITICAL_PROFILER must be defined!
+#else
+#if (OS_CFG_ENABLE_CRITICAL_PROFILER != 1U) &&                                 \
+    (OS_CFG_ENABLE_CRITICAL_PROFILER != 0U)
+#error OS_CFG_ENABLE_CRITICAL_PROFILER needs to be either 1U or 0U!
+#endif
+#endif
+
+#ifndef OS_CFG_ENABLE_STACK_GUARD
+#error OS_CFG_ENABLE_STACK_GUARD must be defined!
+#else
+#if (OS_CFG_ENABLE_STACK_GUARD != 1U) && (OS_CFG_ENABLE_STACK_GUARD != 0U)
+#error OS_CFG_ENABLE_STACK_GUARD needs to be either 1U or 0U!
+#elif OS_CFG_ENABLE_STACK_GUARD && !defined(OS_PORT_STACK_GUARD_SIZE)
+#error OS_CFG_ENABLE_STACK_GUARD is not supported by this port!
+#endif
+#endif
+
+#ifndef OS_CFG_ENABLE_DYNAMIC_TASKS
+#error OS_CFG_ENABLE_DYNAMIC_TASKS must be defined!
+#else
+#if (OS_CFG_ENABLE_DYNAMIC_TASKS != 1U) && (OS_CFG_ENABLE_DYNAMIC_TASKS != 0U)
+#error OS_CFG_ENABLE_DYNAMIC_TASKS needs to be either 1U or 0U!
+#endif
+#endif
+
+#if OS_CFG_ENABLE_DYNAMIC_TASKS
+#ifndef OS_CFG_DYNAMIC_TASK_CNT
+#error OS_CFG_DYNAMIC_TASK_CNT must be defined!
+#elif OS_CFG_DYNAMIC_TASK_CNT == 0U
+#error OS_CFG_DYNAMIC_TASK_CNT needs to be greater than 0!
+#endif
+#ifndef OS_CFG_DYNAMIC_TASK_STACK_SIZE
+#error OS_CFG_DYNAMIC_TASK_STACK_SIZE must be defined!
+#elif (OS_CFG_DYNAMIC_TASK_STACK_SIZE % 8U) != 0U
+#error OS_CFG_DYNAMIC_TASK_STACK_SIZE needs to be a multiple of 8!
+#endif
+#endif
+
+#ifndef OS_CFG_ENABLE_RWLOCKS
+#error OS_CFG_ENABLE_RWLOCKS must be defined!
+#else
+#if (OS_CFG_ENABLE_RWLOCKS != 1U) && (OS_CFG_ENABLE_RWLOCKS != 0U)
+#error OS_CFG_ENABLE_RWLOCKS needs to be either 1U or 0U!
+#endif
+#endif
+
+#if OS_CFG_ENABLE_RWLOCKS
+#ifndef OS_CFG_RWLOCK_READER_CNT
+#error OS_CFG_RWLOCK_READER_CNT must be defined!
+#elif OS_CFG_RWLOCK_READER_CNT == 0U
+#error OS_CFG_RWLOCK_READER_CNT needs to be greater than 0!
+#endif
+#endif
+
 #ifdef __cplusplus
 }
 #endif
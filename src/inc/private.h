@@ -15,9 +15,78 @@ extern "C" {
   } while (0);
 
 /**
- * @brief Type for task entry functions.
+ * @brief Amount of priority levels covered by a single bitmap word.
  */
-typedef void (*os_task_func_t)(void *);
+#define OS_PRIORITY_GROUP_SIZE 32U
+
+/**
+ * @brief Amount of bitmap words needed to cover all priority levels.
+ */
+#define OS_PRIORITY_GROUP_CNT                                                  \
+  ((OS_PRIORITY_LEVEL_CNT + OS_PRIORITY_GROUP_SIZE - 1) /                      \
+   OS_PRIORITY_GROUP_SIZE)
+
+/**
+ * @brief OS_PRIORITY_LEVEL_CNT <= 32 selects a flat bitmap, i.e. a single word
+ * and one CLZ per lookup. Otherwise the two-level form is used, where each bit
+ * of @c group marks a non-empty word of @c levels, and a lookup takes two CLZ.
+ * Since OS_PRIORITY_LEVEL_CNT is a constant, the unused form is optimized
+ * away.
+ */
+#define OS_PRIORITY_IS_FLAT (OS_PRIORITY_LEVEL_CNT <= OS_PRIORITY_GROUP_SIZE)
+
+/**
+ * @brief Priorities are stored in os_u8_t and the group word covers 32 words.
+ */
+typedef char os_priority_level_cnt_check_t[(OS_PRIORITY_LEVEL_CNT <= 256) ? 1
+                                                                          : -1];
+
+#define OS_BITMAP_SET(_bitmap, _priority)                                      \
+  do {                                                                         \
+    if (OS_PRIORITY_IS_FLAT) {                                                 \
+      (_bitmap).levels[0] |= (1UL << (_priority));                             \
+    } else {                                                                   \
+      (_bitmap).levels[(_priority) / OS_PRIORITY_GROUP_SIZE] |=                \
+          (1UL << ((_priority) % OS_PRIORITY_GROUP_SIZE));                     \
+      (_bitmap).group |= (1UL << ((_priority) / OS_PRIORITY_GROUP_SIZE));      \
+    }                                                                          \
+  } while (0)
+
+#define OS_BITMAP_CLEAR(_bitmap, _priority)                                    \
+  do {                                                                         \
+    if (OS_PRIORITY_IS_FLAT) {                                                 \
+      (_bitmap).levels[0] &= ~(1UL << (_priority));                            \
+    } else {                                                                   \
+      (_bitmap).levels[(_priority) / OS_PRIORITY_GROUP_SIZE] &=                \
+          ~(1UL << ((_priority) % OS_PRIORITY_GROUP_SIZE));                    \
+      if ((_bitmap).levels[(_priority) / OS_PRIORITY_GROUP_SIZE] == 0)         \
+        (_bitmap).group &= ~(1UL << ((_priority) / OS_PRIORITY_GROUP_SIZE));   \
+    }                                                                          \
+  } while (0)
+
+#define OS_BITMAP_IS_EMPTY(_bitmap)                                            \
+  (OS_PRIORITY_IS_FLAT ? ((_bitmap).levels[0] == 0) : ((_bitmap).group == 0))
+
+/**
+ * @warning The bitmap can't be empty.
+ */
+#define OS_BITMAP_GET_HIGHEST(_bitmap)                                         \
+  (OS_PRIORITY_IS_FLAT                                                         \
+       ? OS_GET_HIGHEST_PRIORITY((_bitmap).levels[0])                          \
+       : ((OS_GET_HIGHEST_PRIORITY((_bitmap).group) *                         \
+           OS_PRIORITY_GROUP_SIZE) +                                           \
+          OS_GET_HIGHEST_PRIORITY(                                             \
+              (_bitmap).levels[OS_GET_HIGHEST_PRIORITY((_bitmap).group)])))
+
+#define OS_PRIORITY_READY(_priority)                                           \
+  do {                                                                         \
+    OS_BITMAP_SET(os_ctx.ready_priorities, _priority);                         \
+  } while (0)
+#define OS_PRIORITY_UNREADY(_priority)                                         \
+  do {                                                                         \
+    if (os_ctx.priorities[_priority].first == OS_NULL)                         \
+      OS_BITMAP_CLEAR(os_ctx.ready_priorities, _priority);                     \
+  } while (0)
 
 /**
  * @brief Wait return type.
@@ -35,15 +104,30 @@ typedef enum {
   OS_TASK_RUNNING,
   OS_TASK_ASLEEP,
   OS_TASK_WAITING_FOR_EVENT,
+  OS_TASK_WAITING_FOR_NOTIFICATION,
+  OS_TASK_DELETED,
 } os_task_state_t;
 
 typedef enum {
   OS_EVENT_UNINITIALIZED = 0,
   OS_EVENT_MUTEX,
   OS_EVENT_SEMAPHORE,
+  OS_EVENT_MSGQ,
+  OS_EVENT_RING,
+  OS_EVENT_FLAGS,
+  OS_EVENT_POOL,
+  OS_EVENT_RWLOCK,
   OS_EVENT_TOP,
 } os_event_type_t;
 
+/**
+ * @brief Priority bitmap type.
+ */
+typedef struct {
+  os_u32_t group;
+  os_u32_t levels[OS_PRIORITY_GROUP_CNT];
+} os_prio_bitmap_t;
+
 /**
  * @brief Queue type.
  */
@@ -53,13 +137,100 @@ typedef struct {
 } os_queue_t;
 
 /**
- * @brief Event type.
+ * @brief Message queue type. The amount of queued messages is kept in the
+ * count of the owning event.
+ */
+typedef struct {
+  os_u8_t *buffer;
+  os_size_t msg_size;
+  os_size_t depth;
+  os_size_t head;
+} os_msgq_t;
+
+/**
+ * @brief Single-producer single-consumer ring buffer type. @c head is only
+ * written by the producer and @c tail only by the consumer, both run freely
+ * and wrap around at 2^32.
+ */
+typedef struct {
+  os_u8_t *buffer;
+  os_size_t record_size;
+  os_size_t depth;
+  os_size_t wake_level;
+  volatile os_size_t head;
+  volatile os_size_t tail;
+  volatile os_bool_t armed;
+} os_ring_t;
+
+/**
+ * @brief   Rounds a block size up to whole pointers, so every block can hold
+ *          the free list link and stays pointer aligned.
+ */
+#define OS_POOL_BLOCK_WORDS(_block_size)                                       \
+  (((_block_size) + sizeof(void *) - 1U) / sizeof(void *))
+
+/**
+ * @brief Memory pool type. The amount of free blocks is kept in the count of
+ * the owning event.
+ */
+typedef struct {
+  void *free;
+  os_u8_t *buffer;
+  os_size_t block_size;
+  os_size_t block_cnt;
+  os_size_t used_max;
+} os_pool_t;
+
+/**
+ * @brief Link between a lock and a task that holds it. The links of a task
+ * form the list of locks it holds, so the priority it inherits is found
+ * without scanning all events.
+ */
+typedef struct os_hold_t {
+  struct os_tcb_t *task;
+  struct os_event_t *event;
+  struct os_hold_t *prev;
+  struct os_hold_t *next;
+} os_hold_t;
+
+#if OS_CFG_ENABLE_RWLOCKS
+/**
+ * @brief Reader-writer lock type. The writer is kept in the holder of the
+ * owning event and the amount of readers in its count. It's allocated next to
+ * the event, so the reader slots don't grow the other events.
  */
 typedef struct {
+  os_hold_t writer;
+  os_hold_t readers[OS_CFG_RWLOCK_READER_CNT];
+} os_rwlock_t;
+#endif
+
+/**
+ * @brief Event type. The waiting tasks are kept in a single list, sorted by
+ * their current priorities and in FIFO order within a priority. Only the
+ * member of @c data that matches the type is used, a mutex keeps the link to
+ * its holder there.
+ */
+typedef struct os_event_t {
   os_event_type_t type;
   struct os_tcb_t *holder;
-  os_queue_t queue;
+  os_queue_t waiting;
   os_size_t count;
+  union {
+    os_hold_t mutex;
+#if OS_CFG_ENABLE_MESSAGE_QUEUES
+    os_msgq_t msgq;
+#endif
+#if OS_CFG_ENABLE_RING_BUFFERS
+    os_ring_t ring;
+#endif
+#if OS_CFG_ENABLE_MEMORY_POOLS
+    os_pool_t pool;
+#endif
+#if OS_CFG_ENABLE_RWLOCKS
+    os_rwlock_t *rwlock;
+#endif
+  } data;
 } os_event_t;
 
 /**
@@ -77,37 +248,287 @@ typedef struct os_tcb_t {
 
   struct os_tcb_t *next;
   struct os_tcb_t *prev;
+  struct os_tcb_t *delay_next;
+  struct os_tcb_t *delay_prev;
   os_event_t *wait_event;
   os_wait_ret_t wait_return;
+  os_hold_t *held;
 
 #if OS_CFG_ENABLE_MESSAGE_QUEUES
-  os_msgq_t msgq;
+  void *msg;
+  os_bool_t msg_to_front;
+#endif
+
+#if OS_CFG_ENABLE_EVENT_FLAGS
+  os_flags_t flags;
+  os_flags_opt_t flags_options;
+#endif
+
+#if OS_CFG_ENABLE_MEMORY_POOLS
+  void *block;
+#endif
+
+#if OS_CFG_ENABLE_RWLOCKS
+  os_bool_t rwlock_write;
+#endif
+
+#if OS_CFG_ENABLE_TASK_NOTIFICATIONS
+  os_u32_t notify_value;
+  os_u32_t notify_taken;
+  os_bool_t notify_pending;
+  os_bool_t notify_clear;
+#endif
+
+#if OS_CFG_ENABLE_TIME_SLICING
+  os_size_t quantum;
+  os_size_t slice_left;
 #endif
 
 #if OS_CFG_ENABLE_STATS
   os_stack_t *stack_end;
   os_size_t stack_size;
+  os_stack_t *stack_hwm;
+  os_u64_t cycles;
+  os_u32_t voluntary_switches;
+  os_u32_t involuntary_switches;
 #endif
 } os_tcb_t;
 
+/**
+ * @brief   Constant part of a task, generated from OS_TASK_DEFINITIONS into a
+ *          table that stays in flash.
+ */
+typedef struct {
+  os_stack_t *stack;
+  os_stack_t stack_size;
+  os_task_func_t entry_func;
+  void *entry_func_param;
+#if OS_CFG_ENABLE_TIME_SLICING
+  os_size_t quantum;
+#endif
+  os_u8_t priority;
+} os_task_desc_t;
+
+/**
+ * @brief   Constant part of a mutex, semaphore, event flag group or
+ *          reader-writer lock.
+ */
+typedef struct {
+  os_event_type_t type;
+  os_u32_t count;
+} os_event_desc_t;
+
+#if OS_CFG_ENABLE_ISR_POSTS
+/**
+ * @brief   Deferred ISR post. Its sequence number tells the consumer whether
+ *          the record is complete and the producers whether the slot is free.
+ */
+typedef struct {
+  volatile os_u32_t seq;
+  os_isr_post_op_t op;
+  os_event_id_t id;
+  os_u32_t arg;
+} os_isr_post_t;
+
+/**
+ * @brief   Bounded multi-producer queue of deferred ISR posts. Producers only
+ *          reserve a slot with a compare-and-swap, so they never mask
+ *          interrupts. There's a single consumer at a time, guarded by
+ *          @c draining.
+ */
+typedef struct {
+  os_isr_post_t posts[OS_CFG_ISR_POST_QUEUE_DEPTH];
+  os_u32_t head;
+  os_u32_t tail;
+  os_bool_t draining;
+} os_isr_post_queue_t;
+#endif
+
+#if OS_CFG_ENABLE_TRACE
+/**
+ * @brief   Kinds of trace records. The decoder in tools/trace2json.py mirrors
+ *          this list, so only append to it.
+ */
+typedef enum {
+  OS_TRACE_SWITCH,          /* arg: incoming task */
+  OS_TRACE_SCHEDULE,        /* arg: next task */
+  OS_TRACE_ISR_ENTER,       /* arg: nesting count */
+  OS_TRACE_ISR_EXIT,        /* arg: nesting count */
+  OS_TRACE_SYSTICK,         /* arg: unused */
+  OS_TRACE_MUTEX_TAKE,      /* arg: event id */
+  OS_TRACE_MUTEX_BLOCK,     /* arg: event id */
+  OS_TRACE_MUTEX_GIVE,      /* arg: event id */
+  OS_TRACE_SEMAPHORE_TAKE,  /* arg: event id */
+  OS_TRACE_SEMAPHORE_BLOCK, /* arg: event id */
+  OS_TRACE_SEMAPHORE_GIVE,  /* arg: event id */
+  OS_TRACE_PRIORITY,        /* arg: task << 8 | new priority */
+  OS_TRACE_TIMEOUT,         /* arg: task */
+  OS_TRACE_NOTIFY,          /* arg: notified task */
+  OS_TRACE_NOTIFY_BLOCK,    /* arg: unused */
+  OS_TRACE_RWLOCK_READ,     /* arg: event id */
+  OS_TRACE_RWLOCK_WRITE,    /* arg: event id */
+  OS_TRACE_RWLOCK_BLOCK,    /* arg: event id */
+  OS_TRACE_RWLOCK_GIVE,     /* arg: event id */
+} os_trace_event_t;
+
+/**
+ * @brief   A single trace record. @c task is the task running when it was
+ *          recorded, or OS_TRACE_NO_TASK before the kernel started.
+ */
+typedef struct {
+  os_u32_t timestamp;
+  os_u8_t type;
+  os_u8_t task;
+  os_u16_t arg;
+} os_trace_record_t;
+
+#define OS_TRACE_MAGIC 0x5ea17ace
+#define OS_TRACE_NO_TASK 0xffU
+
+/**
+ * @brief   Trace ring buffer. It's meant to be dumped as a whole, e.g. with
+ *          "dump binary value trace.bin os_trace_buffer" in GDB. @c head
+ *          counts all records ever written, the oldest ones get overwritten.
+ */
+typedef struct {
+  os_u32_t magic;
+  os_u16_t depth;
+  os_u16_t record_size;
+  volatile os_u32_t head;
+  os_trace_record_t records[OS_CFG_TRACE_BUFFER_DEPTH];
+} os_trace_buffer_t;
+
+extern os_trace_buffer_t os_trace_buffer;
+#endif /* if OS_CFG_ENABLE_TRACE */
+
+#if OS_CFG_ENABLE_TIMERS
+/**
+ * @brief   Software timer. Armed timers are kept in a delta-ordered list like
+ *          the delayed tasks, expired ones wait for the service task in a
+ *          FIFO list.
+ */
+typedef struct os_timer_t {
+  struct os_timer_t *next;
+  struct os_timer_t *prev;
+  struct os_timer_t *pending_next;
+  os_size_t delay;
+  os_size_t period;
+  os_timer_func_t callback;
+  void *param;
+  os_u8_t options;
+  os_bool_t active;
+  os_bool_t pending;
+} os_timer_t;
+
+/**
+ * @brief   State of the timer service. @c task is set once the service task
+ *          runs, @c idle while it waits for expired timers.
+ */
+typedef struct {
+  os_timer_t *delayed;
+  os_timer_t *pending_first;
+  os_timer_t *pending_last;
+  os_tcb_t *task;
+  os_bool_t idle;
+} os_timer_service_t;
+#endif
+
 /**
  * @brief System context type.
  */
 typedef struct {
   os_bool_t is_running;
 
-  os_tcb_t tcbs[OS_TASK_ID_CNT];
+  os_tcb_t tcbs[OS_TASK_SLOT_CNT];
   os_event_t events[OS_EVENT_ID_CNT];
   os_queue_t priorities[OS_PRIORITY_LEVEL_CNT];
+  os_tcb_t *delayed;
 
-  os_u32_t ready_priorities;
+  os_prio_bitmap_t ready_priorities;
   os_u8_t isr_nesting_cnt;
+
+#if OS_CFG_ENABLE_ISR_POSTS
+  os_isr_post_queue_t isr_posts;
+#endif
+
+#if OS_CFG_ENABLE_STATS
+  os_u32_t stats_switch_time;
+#endif
+
+#if OS_CFG_ENABLE_DYNAMIC_TASKS
+  os_tcb_t *free_tasks;
+  os_tcb_t *exited_tasks;
+#endif
+
+#if OS_CFG_ENABLE_CRITICAL_PROFILER
+  os_critical_site_t *critical_sites;
+  os_critical_site_t *critical_site;
+  os_u32_t critical_start;
+  os_u8_t critical_depth;
+#endif
+
+#if OS_CFG_ENABLE_TIMERS
+  os_timer_t timers[OS_TIMER_ID_CNT];
+  os_timer_service_t timer_service;
+#endif
 } os_ctx_t;
 
+#if OS_CFG_ENABLE_STACK_GUARD
+/**
+ * @brief Words below each stack that are taken by the guard region.
+ */
+#define OS_STACK_GUARD_WORDS OS_PORT_BYTES_TO_SECTORS(OS_PORT_STACK_GUARD_SIZE)
+#define OS_STACK_GUARD_ALIGNED                                                 \
+  __attribute__((aligned(OS_PORT_STACK_GUARD_SIZE)))
+#else
+#define OS_STACK_GUARD_WORDS 0U
+#define OS_STACK_GUARD_ALIGNED
+#endif
+
 extern os_tcb_t *volatile os_curr_task;
 extern os_tcb_t *volatile os_next_task;
 extern os_ctx_t os_ctx;
 
+/**
+ * @brief Set when the kernel needs to see every context switch.
+ */
+#define OS_SWITCH_HOOK                                                         \
+  (OS_CFG_ENABLE_STATS || OS_CFG_ENABLE_TRACE || OS_CFG_ENABLE_STACK_GUARD)
+
+#if OS_SWITCH_HOOK
+/**
+ * @brief   Accounts a context switch in the stats and the trace. Stats charge
+ *          the cycles, the switch and the stack usage to the outgoing task.
+ *          The stack guard is moved to the incoming task.
+ * @note    Ports call it with interrupts masked, right before os_curr_task is
+ *          replaced with os_next_task. Assembly ports reference it weakly, so
+ *          it costs them a single branch when it's compiled out.
+ * @param   sp - stack pointer of the outgoing task
+ */
+void os_switch_hook(os_stack_t *sp);
+#endif
+
+#if OS_CFG_ENABLE_TRACE
+/**
+ * @brief   Appends a record to the trace buffer.
+ * @note    Call this from within a critical section.
+ */
+static inline void os_trace_record(os_trace_event_t type, os_u32_t arg) {
+  os_trace_record_t *record =
+      &os_trace_buffer
+           .records[os_trace_buffer.head++ & (OS_CFG_TRACE_BUFFER_DEPTH - 1U)];
+  record->timestamp = os_port_get_cycles();
+  record->type = (os_u8_t)type;
+  record->task =
+      (os_curr_task != OS_NULL) ? (os_u8_t)os_curr_task->tid : OS_TRACE_NO_TASK;
+  record->arg = (os_u16_t)arg;
+}
+
+#define OS_TRACE(_type, _arg) os_trace_record((_type), (_arg))
+#else
+#define OS_TRACE(_type, _arg)
+#endif
+
 /**
  * @brief This function is called when a task exits.
  */
@@ -126,18 +547,126 @@ void os_schedule(void);
  */
 void os_systick(void);
 
+/**
+ * @brief   Advances the systick by several ticks at once.
+ * @note    It's used to catch up after the SysTick was suppressed by the
+ *          tickless idle mode.
+ * @note    This function contains a critical section.
+ * @param   [in] ticks - amount of elapsed systicks
+ */
+void os_systick_advance(os_size_t ticks);
+
+/**
+ * @brief   Returned by @c os_idle_ticks() when no task is delayed.
+ */
+#define OS_IDLE_TICKS_INFINITE ((os_size_t)-1)
+
+/**
+ * @brief   Gets the amount of systicks the system may stay idle for.
+ * @note    Call this with interrupts disabled.
+ * @return  os_size_t - 0 if the systick shouldn't be suppressed, amount of
+ *          ticks until the nearest timeout or OS_IDLE_TICKS_INFINITE
+ */
+os_size_t os_idle_ticks(void);
+
 /**
  * @brief Initializes a mutex.
  * @param [in] id - id of the mutex
  */
 void os_event_init(os_event_id_t id, os_event_type_t type, os_u32_t count);
 
+/**
+ * @brief Initializes a message queue.
+ * @param [in] id - id of the message queue
+ * @param [in] buffer - storage for depth * msg_size bytes
+ * @param [in] msg_size - size of a single message [in bytes]
+ * @param [in] depth - maximum amount of queued messages
+ */
+void os_msgq_init(os_event_id_t id, os_u8_t *buffer, os_size_t msg_size,
+                  os_size_t depth);
+
+/**
+ * @brief Initializes a ring buffer.
+ * @param [in] id - id of the ring buffer
+ * @param [in] buffer - storage for depth * record_size bytes
+ * @param [in] record_size - size of a single record [in bytes]
+ * @param [in] depth - capacity [in records], a power of two
+ * @param [in] wake_level - amount of records that wakes up the consumer
+ */
+void os_ring_init(os_event_id_t id, os_u8_t *buffer, os_size_t record_size,
+                  os_size_t depth, os_size_t wake_level);
+
+/**
+ * @brief Initializes a memory pool and links all of its blocks.
+ * @param [in] id - id of the memory pool
+ * @param [in] buffer - storage for block_cnt blocks of block_words pointers
+ * @param [in] block_words - size of a single block [in pointers]
+ * @param [in] block_cnt - amount of blocks
+ */
+void os_pool_init(os_event_id_t id, void **buffer, os_size_t block_words,
+                  os_size_t block_cnt);
+
+/**
+ * @brief Initializes a timer and arms it if it's autostarted.
+ * @param [in] id - id of the timer
+ * @param [in] period - period [in systicks]
+ * @param [in] options - OS_TIMER_* options
+ * @param [in] callback - function called on expiry
+ * @param [in] param - callback parameter
+ */
+void os_timer_init(os_timer_id_t id, os_size_t period, os_u8_t options,
+                   os_timer_func_t callback, void *param);
+
+/**
+ * @brief   Advances the timers by several systicks, runs the callbacks of
+ *          expired OS_TIMER_IN_ISR timers and hands the rest to the service
+ *          task. With 0 ticks it only expires the timers that are already due.
+ * @note    This function contains critical sections.
+ * @param   [in] ticks - amount of elapsed systicks
+ */
+void os_timer_advance(os_size_t ticks);
+
+/**
+ * @brief   Runs the callbacks of expired timers, it never returns.
+ * @note    It's the body of the timer service task.
+ */
+void os_timer_service(void);
+
 /**
  * @brief Times out a task and removes it from an event waiting list.
  * @param [in] task - timed out task
  */
 void os_event_timeout(os_tcb_t *task);
 
+/**
+ * @brief   Removes a task from the wait queue of its event and updates the
+ *          priorities of the holders if the event is a mutex or a
+ *          reader-writer lock.
+ * @note    Call this from within a critical section.
+ * @param   [in] task - waiting task
+ */
+void os_event_abort(os_tcb_t *task);
+
+#if OS_CFG_ENABLE_DYNAMIC_TASKS
+/**
+ * @brief   Hands every mutex and reader-writer lock held by a task to the next
+ *          waiters, or frees it. It's meant for deleting tasks.
+ * @note    Call this from within a critical section and call os_schedule()
+ *          after leaving it.
+ * @param   [in] task - holder of the locks
+ */
+void os_event_release_locks(os_tcb_t *task);
+#endif
+
+/**
+ * @brief   Changes the priority of a task waiting for an event and moves it
+ *          to the matching position in the event's wait queue.
+ * @note    Call this from within a critical section.
+ * @param   [in] task - waiting task
+ * @param   [in] new_prio - new priority of the task
+ */
+void os_event_update_priority(os_tcb_t *task, os_u8_t new_prio);
+
 /**
  * @brief   Pushes a task to a queue.
  * @note    Call this from within a critical section.
@@ -156,15 +685,41 @@ void os_queue_pop(os_queue_t *queue);
  */
 void os_queue_remove(os_tcb_t *task, os_queue_t *queue);
 
+/**
+ * @brief   Inserts a task into the delta-ordered list of delayed tasks.
+ * @note    Call this from within a critical section.
+ * @note    ticks == 0 leaves the task out of the list, i.e. it will wait
+ *          indefinitely.
+ * @param   [in] task - delayed task
+ * @param   [in] ticks - amount of systicks to wait
+ */
+void os_delay_insert(os_tcb_t *task, os_size_t ticks);
+
+/**
+ * @brief   Removes a task from the list of delayed tasks, if it's on it.
+ * @note    Call this from within a critical section.
+ * @param   [in] task - task to remove
+ */
+void os_delay_remove(os_tcb_t *task);
+
 /**
  * @brief   Updates a task priority.
  */
 void os_update_priority(os_tcb_t *task, os_u8_t new_prio);
 
+#if OS_CFG_STACK_FILL == OS_STACK_FILL_IDLE
+/**
+ * @brief   Fills the unused part of the stack of every task but the calling
+ *          one, a chunk per critical section. The idle task calls it once.
+ */
+void os_stack_fill(void);
+#endif
+
 /**
  * @brief   Initializes a task's stack.
  * @note    It needs to be implemented in @c os_port.c or @c os_port.s
- * @note    If the stack needs to be aligned, it should be handled here.
+ * @note    If the stack needs to be aligned, it should be handled here. The
+ *          kernel has already filled the stack if OS_CFG_STACK_FILL is set.
  *
  * @param[in] entry_func - pointer to the task's entry function
  * @param[in] stack_ptr - pointer to the beginning of the task's stack
@@ -175,6 +730,33 @@ void os_update_priority(os_tcb_t *task, os_u8_t new_prio);
 os_stack_t *os_port_init_stack(os_task_func_t entry_func, os_stack_t *stack_ptr,
                                os_stack_t stack_size, void *param);
 
+#if OS_CFG_STACK_FILL == OS_STACK_FILL_IDLE
+/**
+ * @brief   Gets the part of a task's stack that holds no data while the task
+ *          is switched out. It's the range from @p *bottom up to, but
+ *          excluding, the returned word.
+ * @note    Call this from within a critical section.
+ *
+ * @param[in] task - a task that isn't running
+ * @param[in,out] bottom - the beginning of the task's stack, moved above any
+ *                data that the port keeps at the bottom
+ * @return os_stack_t* - the lowest word in use
+ */
+os_stack_t *os_port_stack_free(const os_tcb_t *task, os_stack_t **bottom);
+#endif
+
+#if OS_CFG_ENABLE_STACK_GUARD
+/**
+ * @brief   Moves the no-access stack guard region to @p guard.
+ * @note    It's called before os_port_startup() and then on each context
+ *          switch, from os_switch_hook(). os_port_startup() enables the guard.
+ *
+ * @param[in] guard - the lowest OS_PORT_STACK_GUARD_SIZE bytes of a task's
+ *            stack, aligned to their size
+ */
+void os_port_stack_guard(os_stack_t *guard);
+#endif
+
 /**
  * @brief Initializes the system and starts scheduling.
  */
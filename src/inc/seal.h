@@ -15,6 +15,55 @@ extern "C" {
 
 #define OS_UNUSED(_param) _param = _param;
 
+#if OS_CFG_ENABLE_CRITICAL_PROFILER
+/**
+ * @brief   Call site of OS_ENTER_CRITICAL(), with the time that the critical
+ *          sections entered there kept interrupts masked [in cycles of
+ *          os_port_get_cycles()]. Nested critical sections are charged to
+ *          the outermost one.
+ */
+typedef struct os_critical_site_t {
+  const char *file;
+  os_u32_t line;
+  os_u32_t count;
+  os_u32_t max;
+  os_u64_t total;
+  struct os_critical_site_t *next;
+  os_bool_t linked;
+} os_critical_site_t;
+
+/**
+ * @brief Called by OS_ENTER_CRITICAL() once interrupts are masked.
+ */
+void os_critical_profile_enter(os_critical_site_t *site);
+
+/**
+ * @brief Called by OS_EXIT_CRITICAL() before interrupts are unmasked.
+ */
+void os_critical_profile_exit(void);
+
+/*
+ * Every port enters and leaves critical sections through
+ * os_port_enter_critical() and os_port_exit_critical(), so the profiled
+ * macros replace the port ones. Each expansion gets its own site record.
+ */
+#undef OS_ENTER_CRITICAL
+#define OS_ENTER_CRITICAL()                                                    \
+  do {                                                                         \
+    static os_critical_site_t os_critical_site = {.file = __FILE__,            \
+                                                  .line = __LINE__};           \
+    os_critical = os_port_enter_critical();                                    \
+    os_critical_profile_enter(&os_critical_site);                              \
+  } while (0)
+
+#undef OS_EXIT_CRITICAL
+#define OS_EXIT_CRITICAL()                                                     \
+  do {                                                                         \
+    os_critical_profile_exit();                                                \
+    os_port_exit_critical(os_critical);                                        \
+  } while (0)
+#endif /* if OS_CFG_ENABLE_CRITICAL_PROFILER */
+
 typedef enum {
   OS_OK = 0,
   OS_ERROR,
@@ -25,9 +74,100 @@ typedef enum {
   OS_TASK_EXITED,
   OS_STARTUP_EXITED,
   OS_ISR_OVERFLOW,
-  OS_ISR_UNDERFLOW
+  OS_ISR_UNDERFLOW,
+  OS_QUEUE_FULL,
+  OS_STACK_OVERFLOW,
+  OS_TASK_POOL_EMPTY
 } os_error_t;
 
+/**
+ * @brief Event flags type.
+ */
+typedef os_u32_t os_flags_t;
+
+/**
+ * @brief Event flags wait options, OS_FLAGS_WAIT_ANY or OS_FLAGS_WAIT_ALL
+ * optionally combined with OS_FLAGS_CLEAR_ON_EXIT.
+ */
+typedef os_u8_t os_flags_opt_t;
+
+#define OS_FLAGS_WAIT_ANY 0x00U
+#define OS_FLAGS_WAIT_ALL 0x01U
+#define OS_FLAGS_CLEAR_ON_EXIT 0x02U
+
+/**
+ * @brief Timer options. A timer is either one-shot or periodic. Autostarted
+ * timers are armed by os_init(). Callbacks of OS_TIMER_IN_ISR timers run
+ * right in the systick ISR instead of the timer service task, so they need to
+ * be short and may only use the ISR-safe calls.
+ */
+#define OS_TIMER_ONE_SHOT 0x00U
+#define OS_TIMER_PERIODIC 0x01U
+#define OS_TIMER_AUTOSTART 0x02U
+#define OS_TIMER_IN_ISR 0x04U
+
+/**
+ * @brief What a task notification does to the notification value of the task.
+ * Each of them leaves a notification pending.
+ */
+typedef enum {
+  OS_NOTIFY_INCREMENT,
+  OS_NOTIFY_SET_BITS,
+  OS_NOTIFY_OVERWRITE,
+} os_notify_action_t;
+
+/**
+ * @brief Type for task entry functions.
+ */
+typedef void (*os_task_func_t)(void *);
+
+/**
+ * @brief Timer callback type.
+ */
+typedef void (*os_timer_func_t)(void *param);
+
+/**
+ * @brief Memory pool statistics. The block size is in bytes, used_max is the
+ * highest amount of blocks allocated at once since the start.
+ */
+typedef struct {
+  os_size_t block_size;
+  os_size_t block_cnt;
+  os_size_t used;
+  os_size_t used_max;
+} os_pool_stats_t;
+
+/**
+ * @brief Amount of task ids, the static tasks followed by the slots of the
+ * task pool.
+ */
+#if OS_CFG_ENABLE_DYNAMIC_TASKS
+#define OS_TASK_SLOT_CNT (OS_TASK_ID_CNT + OS_CFG_DYNAMIC_TASK_CNT)
+#else
+#define OS_TASK_SLOT_CNT OS_TASK_ID_CNT
+#endif
+
+/**
+ * @brief Runtime statistics of a task. Cycles are counted with
+ * os_port_get_cycles(), stack sizes are in bytes. A switch is voluntary if the
+ * task blocked or went to sleep, and involuntary if it was preempted.
+ */
+typedef struct {
+  os_u64_t cycles;
+  os_u32_t voluntary_switches;
+  os_u32_t involuntary_switches;
+  os_size_t stack_size;
+  os_size_t stack_used_max;
+} os_task_stats_t;
+
+/**
+ * @brief Operations that can be deferred with os_isr_post().
+ */
+typedef enum {
+  OS_ISR_POST_SEMAPHORE_GIVE,
+  OS_ISR_POST_FLAGS_SET,
+} os_isr_post_op_t;
+
 /**
  * @brief Call this function when entering a kernel aware ISR.
  */
@@ -53,6 +193,45 @@ void os_init(void);
  */
 void os_sleep(os_size_t ticks);
 
+/**
+ * @brief   Gets the id of the running task. Called from os_panic_hook(), it
+ *          names the task that caused the panic, e.g. the one that overflowed
+ *          its stack with OS_CFG_ENABLE_STACK_GUARD.
+ * @return  os_task_id_t - id of the running task
+ */
+os_task_id_t os_task_get_id(void);
+
+#if OS_CFG_ENABLE_DYNAMIC_TASKS
+/**
+ * @brief   Starts a task in a free slot of the task pool. It preempts the
+ *          caller if its priority is higher.
+ * @note    It requires OS_CFG_ENABLE_DYNAMIC_TASKS. Don't call it from ISRs.
+ * @param   [out] id - id of the new task, may be OS_NULL
+ * @param   [in] priority - priority of the task, above the idle task and at
+ *          most the highest priority in OS_TASK_DEFINITIONS
+ * @param   [in] entry_func - entry function of the task
+ * @param   [in] param - entry function parameter
+ * @return  OS_OK - the task was started; OS_TASK_POOL_EMPTY - all slots are
+ *          taken; OS_NULL_PARAM - no entry function; OS_ERROR - wrong priority
+ */
+os_error_t os_task_create(os_task_id_t *id, os_u8_t priority,
+                          os_task_func_t entry_func, void *param);
+
+/**
+ * @brief   Stops a task for good. Mutexes it holds are handed to their next
+ *          waiters and it's taken off any wait queue. Slots of the task pool
+ *          are freed for os_task_create(). A task can delete itself, which is
+ *          what returning from its entry function does. Its slot is freed
+ *          once it has been switched out.
+ * @note    It requires OS_CFG_ENABLE_DYNAMIC_TASKS. Don't call it from ISRs.
+ * @param   [in] id - id of the task
+ * @return  OS_OK - the task was deleted; OS_ERROR - it has priority 0, like
+ *          the idle task, it's the timer service task, or it has already
+ *          been deleted
+ */
+os_error_t os_task_delete(os_task_id_t id);
+#endif
+
 /**
  * @brief   Attempts to take a mutex.
  *          @warning Waiting on a semaphore while holding any amount of mutexes
@@ -72,6 +251,52 @@ os_error_t os_mutex_take(os_event_id_t id, os_size_t timeout);
  */
 os_error_t os_mutex_give(os_event_id_t id);
 
+#if OS_CFG_ENABLE_RWLOCKS
+/**
+ * @brief   Attempts to take a reader-writer lock for reading. Any amount of
+ *          readers can hold it at once, up to OS_CFG_RWLOCK_READER_CNT.
+ *          Readers don't overtake waiting writers of the same or higher
+ *          priority, so a stream of readers can't starve a writer. While a
+ *          task waits, the holders run at least at its priority.
+ *          @warning The lock isn't recursive, taking it again while holding
+ *                   it may deadlock once a writer waits.
+ *          @note timeout == 0 indicates that the task is willing to wait
+ *                indefinitely
+ * @param   [in] id - id of the reader-writer lock
+ * @param   [in] timeout - timeout in systicks
+ * @return  OS_OK - lock taken successfully
+ */
+os_error_t os_rwlock_read_take(os_event_id_t id, os_size_t timeout);
+
+/**
+ * @brief   Gives a reader-writer lock taken for reading.
+ * @param   [in] id - id of the reader-writer lock
+ * @return  OS_OK - lock given successfully; OS_ERROR - the task isn't a
+ *          reader of the lock
+ */
+os_error_t os_rwlock_read_give(os_event_id_t id);
+
+/**
+ * @brief   Attempts to take a reader-writer lock for writing, i.e. waits until
+ *          no task holds it. New readers queue up behind the writer unless
+ *          they have a higher priority.
+ *          @note timeout == 0 indicates that the task is willing to wait
+ *                indefinitely
+ * @param   [in] id - id of the reader-writer lock
+ * @param   [in] timeout - timeout in systicks
+ * @return  OS_OK - lock taken successfully
+ */
+os_error_t os_rwlock_write_take(os_event_id_t id, os_size_t timeout);
+
+/**
+ * @brief   Gives a reader-writer lock taken for writing.
+ * @param   [in] id - id of the reader-writer lock
+ * @return  OS_OK - lock given successfully; OS_ERROR - the task isn't the
+ *          writer holding the lock
+ */
+os_error_t os_rwlock_write_give(os_event_id_t id);
+#endif
+
 /**
  * @brief   Attempts to take a semaphore.
  *          @warning Waiting on a semaphore while holding any amount of mutexes
@@ -91,6 +316,334 @@ os_error_t os_semaphore_take(os_event_id_t id, os_size_t timeout);
  */
 os_error_t os_semaphore_give(os_event_id_t id);
 
+#if OS_CFG_ENABLE_MESSAGE_QUEUES
+/**
+ * @brief   Sends a message to the back of a message queue. If a task is
+ *          waiting for a message, it's copied directly into its buffer.
+ *          @note timeout == 0 indicates that the task is willing to wait
+ *                indefinitely
+ * @param   [in] id - id of the message queue
+ * @param   [in] msg - pointer to the message, msg_size bytes are copied
+ * @param   [in] timeout - timeout in systicks
+ * @return  OS_OK - message sent successfully
+ */
+os_error_t os_msgq_send(os_event_id_t id, const void *msg, os_size_t timeout);
+
+/**
+ * @brief   Sends a message to the front of a message queue, so it's received
+ *          before all queued messages.
+ *          @note timeout == 0 indicates that the task is willing to wait
+ *                indefinitely
+ * @param   [in] id - id of the message queue
+ * @param   [in] msg - pointer to the message, msg_size bytes are copied
+ * @param   [in] timeout - timeout in systicks
+ * @return  OS_OK - message sent successfully
+ */
+os_error_t os_msgq_send_to_front(os_event_id_t id, const void *msg,
+                                 os_size_t timeout);
+
+/**
+ * @brief   Sends a message to the back of a message queue without blocking.
+ * @note    It can be called from an ISR.
+ * @param   [in] id - id of the message queue
+ * @param   [in] msg - pointer to the message, msg_size bytes are copied
+ * @return  OS_OK - message sent successfully; OS_QUEUE_FULL - no room left
+ */
+os_error_t os_msgq_post(os_event_id_t id, const void *msg);
+
+/**
+ * @brief   Receives a message from a message queue.
+ *          @note timeout == 0 indicates that the task is willing to wait
+ *                indefinitely
+ * @param   [in] id - id of the message queue
+ * @param   [out] msg - buffer for the message, at least msg_size bytes
+ * @param   [in] timeout - timeout in systicks
+ * @return  OS_OK - message received successfully
+ */
+os_error_t os_msgq_receive(os_event_id_t id, void *msg, os_size_t timeout);
+
+/**
+ * @brief   Sends a pointer through a message queue declared with
+ *          msg_size == sizeof(void *). Use it to pass large buffers without
+ *          copying them.
+ * @param   [in] id - id of the message queue
+ * @param   [in] ptr - pointer to send
+ * @param   [in] timeout - timeout in systicks
+ * @return  OS_OK - pointer sent successfully
+ */
+os_error_t os_msgq_send_ptr(os_event_id_t id, void *ptr, os_size_t timeout);
+
+/**
+ * @brief   Receives a pointer sent with @c os_msgq_send_ptr().
+ * @param   [in] id - id of the message queue
+ * @param   [out] ptr - received pointer
+ * @param   [in] timeout - timeout in systicks
+ * @return  OS_OK - pointer received successfully
+ */
+os_error_t os_msgq_receive_ptr(os_event_id_t id, void **ptr,
+                               os_size_t timeout);
+#endif
+
+#if OS_CFG_ENABLE_RING_BUFFERS
+/**
+ * @brief   Writes records to a ring buffer without entering a critical
+ *          section, unless the waiting consumer needs to be woken up.
+ * @note    It can be called from an ISR. There can be only one producer.
+ * @param   [in] id - id of the ring buffer
+ * @param   [in] data - records to write
+ * @param   [in] count - amount of records to write
+ * @return  os_size_t - amount of records written, less than count if the
+ *          ring buffer got full
+ */
+os_size_t os_ring_write(os_event_id_t id, const void *data, os_size_t count);
+
+/**
+ * @brief   Reads records from a ring buffer without blocking.
+ * @note    There can be only one consumer.
+ * @param   [in] id - id of the ring buffer
+ * @param   [out] data - buffer for the records
+ * @param   [in] count - maximum amount of records to read
+ * @return  os_size_t - amount of records read
+ */
+os_size_t os_ring_read(os_event_id_t id, void *data, os_size_t count);
+
+/**
+ * @brief   Gets the amount of records in a ring buffer.
+ * @param   [in] id - id of the ring buffer
+ * @return  os_size_t - amount of records
+ */
+os_size_t os_ring_count(os_event_id_t id);
+
+/**
+ * @brief   Waits until a ring buffer holds at least its wake level of
+ *          records. The producer signals the consumer once per batch.
+ *          @note timeout == 0 indicates that the task is willing to wait
+ *                indefinitely
+ * @param   [in] id - id of the ring buffer
+ * @param   [in] timeout - timeout in systicks
+ * @return  OS_OK - wake level reached
+ */
+os_error_t os_ring_wait(os_event_id_t id, os_size_t timeout);
+#endif
+
+#if OS_CFG_ENABLE_EVENT_FLAGS
+/**
+ * @brief   Sets flags of an event flag group and wakes up all tasks whose
+ *          wait condition became true.
+ * @note    It can be called from an ISR.
+ * @param   [in] id - id of the event flag group
+ * @param   [in] mask - flags to set
+ * @return  OS_OK - flags set successfully
+ */
+os_error_t os_flags_set(os_event_id_t id, os_flags_t mask);
+
+/**
+ * @brief   Clears flags of an event flag group.
+ * @param   [in] id - id of the event flag group
+ * @param   [in] mask - flags to clear
+ * @return  OS_OK - flags cleared successfully
+ */
+os_error_t os_flags_clear(os_event_id_t id, os_flags_t mask);
+
+/**
+ * @brief   Gets the current flags of an event flag group.
+ * @param   [in] id - id of the event flag group
+ * @return  os_flags_t - current flags
+ */
+os_flags_t os_flags_get(os_event_id_t id);
+
+/**
+ * @brief   Waits until any or all of the flags in mask are set.
+ *          @note timeout == 0 indicates that the task is willing to wait
+ *                indefinitely
+ * @param   [in] id - id of the event flag group
+ * @param   [in] mask - flags to wait for
+ * @param   [in] options - OS_FLAGS_WAIT_ANY or OS_FLAGS_WAIT_ALL, optionally
+ *          combined with OS_FLAGS_CLEAR_ON_EXIT to clear the flags in mask
+ *          once the condition is met
+ * @param   [in] timeout - timeout in systicks
+ * @param   [out] flags - flags that satisfied the condition, may be OS_NULL
+ * @return  OS_OK - condition met
+ */
+os_error_t os_flags_wait(os_event_id_t id, os_flags_t mask,
+                         os_flags_opt_t options, os_size_t timeout,
+                         os_flags_t *flags);
+#endif
+
+#if OS_CFG_ENABLE_MEMORY_POOLS
+/**
+ * @brief   Allocates a block from a memory pool, waiting for one to be freed
+ *          if the pool is exhausted.
+ *          @warning Don't call it from an ISR, use os_pool_try_alloc()
+ *          @note timeout == 0 indicates that the task is willing to wait
+ *                indefinitely
+ * @param   [in] id - id of the memory pool
+ * @param   [out] block - allocated block
+ * @param   [in] timeout - timeout in systicks
+ * @return  OS_OK - block allocated successfully
+ */
+os_error_t os_pool_alloc(os_event_id_t id, void **block, os_size_t timeout);
+
+/**
+ * @brief   Allocates a block from a memory pool without blocking.
+ * @note    It can be called from an ISR.
+ * @param   [in] id - id of the memory pool
+ * @return  void* - allocated block, OS_NULL if the pool is exhausted
+ */
+void *os_pool_try_alloc(os_event_id_t id);
+
+/**
+ * @brief   Returns a block to its memory pool. If a task is waiting for a
+ *          block, it's handed the block directly.
+ * @note    It can be called from an ISR.
+ * @param   [in] id - id of the memory pool
+ * @param   [in] block - block allocated from this pool
+ * @return  OS_OK - block freed successfully
+ *          OS_ERROR - the block doesn't belong to this pool
+ */
+os_error_t os_pool_free(os_event_id_t id, void *block);
+
+/**
+ * @brief   Gets the usage statistics of a memory pool.
+ * @param   [in] id - id of the memory pool
+ * @param   [out] stats - statistics
+ * @return  OS_OK - statistics copied successfully
+ */
+os_error_t os_pool_get_stats(os_event_id_t id, os_pool_stats_t *stats);
+#endif
+
+#if OS_CFG_ENABLE_STATS
+/**
+ * @brief   Copies the statistics of all tasks at once, including the slots
+ *          of the task pool. Deleted tasks and free slots report zeros.
+ * @param   [out] stats - array of OS_TASK_SLOT_CNT entries, indexed by task
+ *          id
+ * @return  OS_OK - statistics copied successfully
+ */
+os_error_t os_task_stats_snapshot(os_task_stats_t *stats);
+#endif
+
+#if OS_CFG_ENABLE_TIMERS
+/**
+ * @brief   Arms a timer. A running timer is restarted.
+ * @param   [in] id - id of the timer
+ * @param   [in] delay - systicks until the first expiry, 0 uses the period
+ * @return  OS_OK - timer started successfully
+ *          OS_ERROR - both the delay and the period are 0
+ */
+os_error_t os_timer_start(os_timer_id_t id, os_size_t delay);
+
+/**
+ * @brief   Disarms a timer and drops its callback if it's still pending.
+ * @param   [in] id - id of the timer
+ * @return  OS_OK - timer stopped successfully
+ */
+os_error_t os_timer_stop(os_timer_id_t id);
+
+/**
+ * @brief   Changes the period of a timer. It takes effect at the next expiry.
+ * @param   [in] id - id of the timer
+ * @param   [in] period - new period [in systicks]
+ * @return  OS_OK - period changed successfully
+ *          OS_ERROR - a periodic timer can't have a period of 0
+ */
+os_error_t os_timer_set_period(os_timer_id_t id, os_size_t period);
+
+/**
+ * @brief   Checks whether a timer is armed.
+ * @param   [in] id - id of the timer
+ * @return  OS_TRUE - the timer is armed
+ */
+os_bool_t os_timer_is_active(os_timer_id_t id);
+
+/**
+ * @brief   Entry function of the timer service task.
+ */
+void timer_entry(void *param);
+#endif
+
+#if OS_CFG_ENABLE_TASK_NOTIFICATIONS
+/**
+ * @brief   Notifies a task directly, without going through an event. A task
+ *          waiting in os_task_notify_wait() is made ready right away.
+ * @note    It can be called from an ISR.
+ * @param   [in] id - id of the notified task
+ * @param   [in] action - how the notification value is updated
+ * @param   [in] value - OS_NOTIFY_SET_BITS: bits to set;
+ *          OS_NOTIFY_OVERWRITE: new value; ignored otherwise
+ * @return  OS_OK - task notified successfully
+ *          OS_ERROR - unknown action, or the task has been deleted
+ */
+os_error_t os_task_notify(os_task_id_t id, os_notify_action_t action,
+                          os_u32_t value);
+
+/**
+ * @brief   Increments the notification value of a task, so that it can be
+ *          used like a counting semaphore.
+ * @note    It can be called from an ISR.
+ * @param   [in] id - id of the notified task
+ * @return  OS_OK - task notified successfully
+ */
+os_error_t os_task_notify_give(os_task_id_t id);
+
+/**
+ * @brief   Waits until the current task has a pending notification.
+ *          @note timeout == 0 indicates that the task is willing to wait
+ *                indefinitely
+ * @param   [in] clear - OS_TRUE clears the whole notification value,
+ *          OS_FALSE takes a single count of it, like a semaphore take
+ * @param   [in] timeout - timeout in systicks
+ * @param   [out] value - notification value before it was taken, may be
+ *          OS_NULL
+ * @return  OS_OK - notification received
+ */
+os_error_t os_task_notify_wait(os_bool_t clear, os_size_t timeout,
+                               os_u32_t *value);
+#endif
+
+#if OS_CFG_ENABLE_ISR_POSTS
+/**
+ * @brief   Defers a kernel call from an ISR. The post is only appended to a
+ *          lock-free queue, which is drained by the outermost os_exit_isr().
+ *          Interrupts stay enabled while posting, and the kernel calls made
+ *          while draining mask them only for their own duration.
+ * @note    Called outside of an ISR, the post is executed right away.
+ * @param   [in] op - deferred operation
+ * @param   [in] id - id of the event
+ * @param   [in] arg - OS_ISR_POST_FLAGS_SET: flags to set, ignored otherwise
+ * @return  OS_OK - operation posted successfully
+ *          OS_QUEUE_FULL - the post queue is full, call the kernel directly
+ *          OS_WRONG_EVENT - OS_ISR_POST_FLAGS_SET without
+ *          OS_CFG_ENABLE_EVENT_FLAGS
+ */
+os_error_t os_isr_post(os_isr_post_op_t op, os_event_id_t id, os_u32_t arg);
+#endif
+
+#if OS_CFG_ENABLE_CRITICAL_PROFILER
+/**
+ * @brief Type of the function that receives the sites in
+ * os_critical_profile_dump().
+ */
+typedef void (*os_critical_dump_func_t)(const os_critical_site_t *site);
+
+/**
+ * @brief   Passes a copy of every critical section call site that has been
+ *          entered since the last reset to @p func. Interrupts are only
+ *          masked while a site is copied, not while @p func runs.
+ * @note    It requires OS_CFG_ENABLE_CRITICAL_PROFILER. tools/critprof.py
+ *          ranks sites printed as "critical <file>:<line> <count> <total>
+ *          <max>".
+ * @param   [in] func - function called for each site
+ */
+void os_critical_profile_dump(os_critical_dump_func_t func);
+
+/**
+ * @brief   Zeroes the counters of every site, e.g. to leave out the boot.
+ * @note    It requires OS_CFG_ENABLE_CRITICAL_PROFILER.
+ */
+void os_critical_profile_reset(void);
+#endif
+
 /**
  * @brief This function is called when something really bad happens.
  */
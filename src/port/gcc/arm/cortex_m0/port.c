@@ -0,0 +1,204 @@
+#include "private.h"
+
+const os_u8_t os_port_debruijn_msb[32] = {
+    0,  9,  1,  10, 13, 21, 2,  29, 11, 14, 16, 18, 22, 25, 3, 30,
+    8,  12, 20, 28, 15, 17, 24, 7,  19, 27, 23, 6,  26, 5,  4, 31};
+
+os_stack_t *os_port_init_stack(os_task_func_t entry_func, os_stack_t *stack_ptr,
+                               os_stack_t stack_size, void *param) {
+  os_stack_t *ptr = &stack_ptr[stack_size];
+  ptr = (os_stack_t *)((os_stack_t)(ptr)&0xfffffff8U); /* align to 8 bytes */
+  *(--ptr) = (os_stack_t)0x01000000UL; /* xPSR : set thumb state */
+  *(--ptr) = (os_stack_t)entry_func & (os_stack_t)0xfffffffe;   /* task entry */
+  *(--ptr) = (os_stack_t)os_task_exit & (os_stack_t)0xfffffffe; /* LR */
+  *(--ptr) = (os_stack_t)0x0000000CUL;                          /* R12 */
+  *(--ptr) = (os_stack_t)0x00000003UL;                          /* R3 */
+  *(--ptr) = (os_stack_t)0x00000002UL;                          /* R2 */
+  *(--ptr) = (os_stack_t)0x00000001UL;                          /* R1 */
+  *(--ptr) = (os_stack_t)param;                                 /* R0 */
+  *(--ptr) = (os_stack_t)0x0000000BUL;                          /* R11 */
+  *(--ptr) = (os_stack_t)0x0000000AUL;                          /* R10 */
+  *(--ptr) = (os_stack_t)0x00000009UL;                          /* R9 */
+  *(--ptr) = (os_stack_t)0x00000008UL;                          /* R8 */
+  *(--ptr) = (os_stack_t)0x00000007UL;                          /* R7 */
+  *(--ptr) = (os_stack_t)0x00000006UL;                          /* R6 */
+  *(--ptr) = (os_stack_t)0x00000005UL;                          /* R5 */
+  *(--ptr) = (os_stack_t)0x00000004UL;                          /* R4 */
+  return ptr;
+}
+
+#if OS_CFG_STACK_FILL == OS_STACK_FILL_IDLE
+os_stack_t *os_port_stack_free(const os_tcb_t *task, os_stack_t **bottom) {
+  OS_UNUSED(bottom);
+  return task->stack_ptr;
+}
+#endif
+
+static os_stack_t os_exception_stack[256];
+
+/** @brief Amount of handled systicks, used to extend the SysTick counter. */
+static volatile os_u32_t os_port_tick_cnt = 0;
+
+#if OS_CFG_ENABLE_TICKLESS_IDLE
+/** @brief SysTick counts per systick, captured before the first suppression. */
+static os_reg_t os_port_tick_reload = 0;
+/** @brief SysTick control bits, written whole to stop the counter without
+ * reading COUNTFLAG, which clears it. */
+static os_reg_t os_port_tick_ctrl = 0;
+#endif
+
+void os_port_startup(void) {
+  OS_DISABLE_INTERRUPTS();
+
+  os_curr_task = os_next_task;
+  OS_PORT_SHPR3_REG |= OS_PORT_SHPR3_PENDSV_PRIO_VAL;
+#if OS_CFG_ENABLE_TICKLESS_IDLE
+  os_port_tick_reload = OS_PORT_SYSTICK_LOAD_REG + 1;
+  os_port_tick_ctrl = OS_PORT_SYSTICK_CTRL_REG & ~OS_PORT_SYSTICK_COUNTFLAG_BIT;
+#endif
+  os_ctx.is_running = OS_TRUE;
+
+  /* get top of stack and align to 8 bytes */
+  os_stack_t *exception_stack;
+  exception_stack = &os_exception_stack[OS_ARRAY_SIZE(os_exception_stack)];
+  exception_stack = (os_stack_t *)((os_stack_t)exception_stack & 0xfffffff8U);
+
+  __asm volatile(
+      "msr msp, %0                  \n" /* load exception stack as msp */
+      "                             \n"
+      "ldr r3, [%1]                 \n" /* load new process stack pointer */
+      "adds r3, r3, #32             \n" /* skip r4-r11, they're unused */
+      "msr psp, r3                  \n" /* load it to psp */
+      "                             \n"
+      "movs r0, #2                  \n" /* set psp as the current stack pointer
+                                         */
+      "msr control, r0              \n"
+      "isb                          \n"
+      "                             \n"
+      "pop {r0-r5}                  \n" /* r0-r3, r12 and lr */
+      "mov lr, r5                   \n"
+      "pop {r2, r3}                 \n" /* pc and xpsr */
+      "movs r1, #1                  \n" /* ensure pc[0] is set */
+      "orrs r2, r1                  \n"
+      "                             \n"
+      "cpsie i                      \n" /* enable interrupts */
+      "bx r2                        \n" /* start task */
+      ".align 4                     \n"
+      :
+      : "r"(exception_stack), "r"(os_curr_task)
+      : "memory");
+}
+
+void os_port_systick_handler(void) {
+  os_port_tick_cnt++;
+  os_enter_isr();
+  os_systick();
+  os_exit_isr();
+}
+
+void os_port_cycle_counter_init(void) {}
+
+os_u32_t os_port_get_cycles(void) {
+  os_u32_t ticks;
+  os_reg_t val;
+  os_reg_t pending;
+#if OS_CFG_ENABLE_TICKLESS_IDLE
+  /* LOAD holds a stretched period while the idle task sleeps */
+  os_reg_t reload = (os_port_tick_reload != 0) ? os_port_tick_reload
+                                               : OS_PORT_SYSTICK_LOAD_REG + 1;
+#else
+  os_reg_t reload = OS_PORT_SYSTICK_LOAD_REG + 1;
+#endif
+  do {
+    ticks = os_port_tick_cnt;
+    val = OS_PORT_SYSTICK_VAL_REG;
+    /* with interrupts masked the counter may have wrapped without the
+     * handler running yet, then VAL is read again past the wrap */
+    pending = OS_PORT_NVIC_INT_CTRL_REG & OS_PORT_NVIC_PENDSTSET_BIT;
+    if (pending) {
+      val = OS_PORT_SYSTICK_VAL_REG;
+    }
+  } while (ticks != os_port_tick_cnt);
+  if (pending) {
+    ticks++;
+  }
+  return (ticks * reload) + (reload - 1 - val);
+}
+
+/**
+ * @brief   ARMv6-M has no exclusive access instructions, so GCC calls this
+ *          for __atomic_compare_exchange_n() on words. Interrupts are masked
+ *          for a handful of instructions.
+ */
+_Bool __atomic_compare_exchange_4(volatile void *ptr, void *expected,
+                                  unsigned int desired, _Bool weak,
+                                  int success_memorder, int failure_memorder) {
+  OS_DECLARE_CRITICAL();
+  _Bool ret;
+  OS_ENTER_CRITICAL();
+  if (*(volatile unsigned int *)ptr == *(unsigned int *)expected) {
+    *(volatile unsigned int *)ptr = desired;
+    ret = OS_TRUE;
+  } else {
+    *(unsigned int *)expected = *(volatile unsigned int *)ptr;
+    ret = OS_FALSE;
+  }
+  OS_EXIT_CRITICAL();
+  return ret;
+}
+
+#if OS_CFG_ENABLE_TICKLESS_IDLE
+void os_port_tickless_idle(void) {
+  OS_DISABLE_INTERRUPTS();
+  os_size_t ticks = os_idle_ticks();
+  if (ticks == 0) {
+    OS_ENABLE_INTERRUPTS();
+    return;
+  }
+  if (ticks > OS_PORT_SYSTICK_MAX_LOAD / os_port_tick_reload) {
+    ticks = OS_PORT_SYSTICK_MAX_LOAD / os_port_tick_reload;
+  }
+
+  /* stop the SysTick and stretch the current tick over the idle period */
+  OS_PORT_SYSTICK_CTRL_REG &= ~OS_PORT_SYSTICK_ENABLE_BIT;
+  os_reg_t remaining = OS_PORT_SYSTICK_VAL_REG;
+  os_reg_t idle_load = remaining + (ticks - 1) * os_port_tick_reload;
+  OS_PORT_SYSTICK_LOAD_REG = idle_load;
+  OS_PORT_SYSTICK_VAL_REG = 0;
+  OS_PORT_SYSTICK_CTRL_REG |= OS_PORT_SYSTICK_ENABLE_BIT;
+
+  __asm volatile("dsb \n"
+                 "wfi \n"
+                 "isb \n" ::
+                     : "memory");
+
+  /* stop the counter first, so it can't wrap between the samples below */
+  OS_PORT_SYSTICK_CTRL_REG = os_port_tick_ctrl & ~OS_PORT_SYSTICK_ENABLE_BIT;
+  os_reg_t ctrl = OS_PORT_SYSTICK_CTRL_REG;
+  os_reg_t counted = idle_load - OS_PORT_SYSTICK_VAL_REG;
+  os_size_t elapsed;
+  if (ctrl & OS_PORT_SYSTICK_COUNTFLAG_BIT) {
+    /* the pending SysTick handler accounts for the last tick, counted is
+     * how far the counter got into the next one */
+    elapsed = ticks - 1;
+  } else {
+    /* woken up early by another interrupt */
+    counted += os_port_tick_reload - remaining;
+    elapsed = 0;
+  }
+  elapsed += counted / os_port_tick_reload;
+  os_reg_t partial = counted % os_port_tick_reload;
+  /* the handler counted none of the suppressed ticks */
+  os_port_tick_cnt += elapsed;
+
+  /* finish the current tick, then resume the regular period */
+  OS_PORT_SYSTICK_LOAD_REG = os_port_tick_reload - partial - 1;
+  OS_PORT_SYSTICK_VAL_REG = 0;
+  OS_PORT_SYSTICK_CTRL_REG |= OS_PORT_SYSTICK_ENABLE_BIT;
+  OS_PORT_SYSTICK_LOAD_REG = os_port_tick_reload - 1;
+
+  os_systick_advance(elapsed);
+  OS_ENABLE_INTERRUPTS();
+  os_schedule();
+}
+#endif
@@ -0,0 +1,157 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OS_TRUE 1U
+#define OS_FALSE 0U
+#define OS_NULL ((void *)0)
+
+typedef unsigned char os_bool_t;
+
+typedef unsigned char os_u8_t;
+typedef unsigned short int os_u16_t;
+typedef unsigned long int os_u32_t;
+typedef unsigned long long int os_u64_t;
+typedef signed char os_i8_t;
+typedef signed short int os_i16_t;
+typedef signed long int os_i32_t;
+typedef signed long long int os_i64_t;
+
+typedef float os_f32_t;
+typedef double os_f64_t;
+
+typedef os_u32_t os_reg_t;
+typedef os_u32_t os_size_t;
+typedef os_u32_t os_stack_t;
+
+/**
+ * @brief This macro converts _bytes to an amount of os_stack_t entries.
+ */
+#define OS_PORT_BYTES_TO_SECTORS(_bytes) (_bytes >> 2)
+
+/**
+ * @brief Orders memory accesses, e.g. between a producer and a consumer
+ * that don't share a critical section.
+ */
+#define OS_MEMORY_BARRIER()                                                    \
+  do {                                                                         \
+    __asm volatile("dmb" ::: "memory");                                        \
+  } while (0)
+
+#define OS_DISABLE_INTERRUPTS()                                                \
+  do {                                                                         \
+    __asm volatile("cpsid i" ::: "memory");                                    \
+  } while (0)
+
+#define OS_ENABLE_INTERRUPTS()                                                 \
+  do {                                                                         \
+    __asm volatile("cpsie i" ::: "memory");                                    \
+  } while (0)
+
+/**
+ * @brief Call this macro at the entry of each function that has any critical
+ * sections.
+ */
+#define OS_DECLARE_CRITICAL() os_reg_t os_critical = 0;
+
+/**
+ * @brief   Call this macro to enter a critical section.
+ * @note    It requires OS_DECLARE_CRITICAL() to be called at the entry of the
+ * function.
+ * @warning If pairs of OS_ENTER_CRITICAL() and OS_EXIT_CRITICAL() are not
+ * balanced, a kernel panic will occur after 256 unbalanced calls.
+ */
+#define OS_ENTER_CRITICAL()                                                    \
+  do {                                                                         \
+    os_critical = os_port_enter_critical();                                    \
+  } while (0)
+
+/**
+ * @brief   Call this macro to exit a critical section.
+ * @note    It requires OS_DECLARE_CRITICAL() to be called at the entry of the
+ * function.
+ * @warning If pairs of OS_ENTER_CRITICAL() and OS_EXIT_CRITICAL() are not
+ * balanced, a kernel panic will occur after 256 unbalanced calls.
+ */
+#define OS_EXIT_CRITICAL()                                                     \
+  do {                                                                         \
+    os_port_exit_critical(os_critical);                                        \
+  } while (0)
+
+/**
+ * @brief This function is specific to this port of osrtos. Use
+ * OS_ENTER_CRITICAL() for better portability.
+ * @note ARMv6-M has no BASEPRI, so critical sections mask all interrupts
+ * with PRIMASK.
+ * @return os_reg_t - value of primask upon entering the critical section
+ */
+static inline os_reg_t os_port_enter_critical(void) {
+  os_reg_t primask;
+  __asm volatile("mrs %0, primask\n\t"
+                 "cpsid i"
+                 : "=r"(primask)
+                 :
+                 : "memory");
+  return primask;
+}
+
+/**
+ * @brief This function is specific to this port of osrtos. Use
+ * OS_EXIT_CRITICAL() for better portability.
+ * @note The isb makes a PendSV requested inside the critical section fire
+ * before the caller goes on.
+ * @param new_primask - value of primask to restore
+ */
+static inline void os_port_exit_critical(os_reg_t new_primask) {
+  __asm volatile("msr primask, %0\n\t"
+                 "isb"
+                 :
+                 : "r"(new_primask)
+                 : "memory");
+}
+
+/**
+ * @brief SysTick handler used by osrtos.
+ *
+ * This function needs to be called each time a systick occurs. It can be either
+ * be called directly as the handler, or it can be called inside another
+ * handler.
+ */
+void os_port_systick_handler(void);
+
+/**
+ * @brief Puts the CPU to sleep with the SysTick suppressed until the nearest
+ * timeout, then catches up the elapsed ticks.
+ *
+ * It's called by the idle task when OS_CFG_ENABLE_TICKLESS_IDLE is set.
+ */
+void os_port_tickless_idle(void);
+
+/**
+ * @brief Starts the free-running counter read by os_port_get_cycles(). It does
+ * nothing on this port, the SysTick is always running.
+ */
+void os_port_cycle_counter_init(void);
+
+/**
+ * @brief Reads the free-running cycle counter.
+ *
+ * ARMv6-M has no DWT cycle counter, so the count is derived from the SysTick
+ * and the amount of handled systicks, at the SysTick clock rate.
+ * @return os_u32_t - current count, wrapping around at 2^32
+ */
+os_u32_t os_port_get_cycles(void);
+
+/**
+ * @brief PendSV handler used by osrtos.
+ *
+ * This function switches the context of the CPU. It needs to be called directly
+ * as the handler, otherwise it will cause a HardFault.
+ */
+void os_port_pendsv_handler(void);
+
+#ifdef __cplusplus
+}
+#endif
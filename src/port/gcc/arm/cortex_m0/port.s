@@ -0,0 +1,76 @@
+.extern  os_curr_task
+.extern  os_next_task
+.weak    os_switch_hook
+
+.global  os_port_pendsv_handler
+.global  os_port_context_switch
+
+.equ OS_PORT_NVIC_INT_CTRL_REG,     0xE000ED04
+.equ OS_PORT_NVIC_PENDSVSET_BIT,    0x10000000
+
+.text
+.align 4
+.thumb
+.syntax unified
+
+.thumb_func
+os_port_context_switch:
+    ldr r0, =OS_PORT_NVIC_INT_CTRL_REG
+    ldr r1, =OS_PORT_NVIC_PENDSVSET_BIT
+    str r1, [r0]
+    dsb
+    isb
+    bx lr
+
+/*
+ * ARMv6-M can only store and load r0-r7 in bulk and only with increasing
+ * addresses, so r8-r11 go through r4-r7. The frame has the same layout as on
+ * ARMv7-M, r4 at the lowest address.
+ */
+.thumb_func
+os_port_pendsv_handler:
+    cpsid i                  /* disable interrupts */
+
+    mrs r0, psp              /* load old process stack pointer */
+    subs r0, r0, #32         /* make room for r4-r11 */
+
+    ldr r1, =os_curr_task    /* get address of current taskptr */
+    ldr r2, [r1]             /* get address of current task and stack pointer */
+    str r0, [r2]             /* store stack pointer to current task */
+
+    stmia r0!, {r4-r7}       /* push low registers */
+    mov r4, r8
+    mov r5, r9
+    mov r6, r10
+    mov r7, r11
+    stmia r0!, {r4-r7}       /* push high registers */
+
+    ldr r3, =os_switch_hook  /* account the switch, if it's compiled in */
+    cmp r3, #0
+    beq 1f
+    push {r1, lr}
+    ldr r0, [r2]             /* pass the old stack pointer */
+    blx r3
+    pop {r1, r2}
+    mov lr, r2
+1:
+
+    ldr r3, =os_next_task    /* get address of next taskptr */
+    ldr r2, [r3]             /* get address of next task and stack pointer */
+    str r2, [r1]             /* set next task as current task */
+
+    ldr r0, [r2]             /* get value of next stack pointer */
+    adds r0, r0, #16         /* pop high registers first */
+    ldmia r0!, {r4-r7}
+    mov r8, r4
+    mov r9, r5
+    mov r10, r6
+    mov r11, r7
+    msr psp, r0              /* load new process stack pointer */
+    subs r0, r0, #32
+    ldmia r0!, {r4-r7}       /* pop low registers */
+
+    cpsie i                  /* enable interrupts */
+    bx lr
+
+.end
@@ -0,0 +1,50 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ARMv6-M only allows word accesses to the system handler priorities */
+#define OS_PORT_SHPR3_REG *((volatile os_reg_t *)0xe000ed20)
+#define OS_PORT_SHPR3_PENDSV_PRIO_VAL (0xffUL << 16UL)
+#define OS_PORT_NVIC_INT_CTRL_REG *((volatile os_reg_t *)0xe000ed04)
+#define OS_PORT_NVIC_PENDSVSET_BIT (1UL << 28UL)
+#define OS_PORT_NVIC_PENDSTSET_BIT (1UL << 26UL)
+
+#define OS_PORT_SYSTICK_CTRL_REG *((volatile os_reg_t *)0xe000e010)
+#define OS_PORT_SYSTICK_LOAD_REG *((volatile os_reg_t *)0xe000e014)
+#define OS_PORT_SYSTICK_VAL_REG *((volatile os_reg_t *)0xe000e018)
+#define OS_PORT_SYSTICK_ENABLE_BIT (1UL << 0UL)
+#define OS_PORT_SYSTICK_COUNTFLAG_BIT (1UL << 16UL)
+#define OS_PORT_SYSTICK_MAX_LOAD (0x00ffffffUL)
+
+#define OS_CTX_SWITCH() os_port_context_switch()
+#define OS_CTX_SWITCH_FROM_ISR() os_port_context_switch()
+
+/** @brief This function triggers PendSV. */
+void os_port_context_switch(void);
+
+/** @brief Bit positions indexed by the top 5 bits of the de Bruijn product. */
+extern const os_u8_t os_port_debruijn_msb[32];
+
+/**
+ * @brief   Gets the index of the highest set bit of a non-zero 32-bit word.
+ * @note    ARMv6-M has no CLZ. The word is smeared down to 2^(n+1)-1, which
+ *          multiplied by a de Bruijn constant gives a unique top 5 bits for
+ *          each n.
+ */
+static inline os_u32_t os_port_get_highest_bit(os_u32_t word) {
+  word |= word >> 1;
+  word |= word >> 2;
+  word |= word >> 4;
+  word |= word >> 8;
+  word |= word >> 16;
+  return os_port_debruijn_msb[(os_u32_t)(word * 0x07c4acddUL) >> 27];
+}
+
+#define OS_GET_HIGHEST_PRIORITY(_priorities)                                   \
+  os_port_get_highest_bit(_priorities)
+
+#ifdef __cplusplus
+}
+#endif
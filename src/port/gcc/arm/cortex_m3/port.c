@@ -1,4 +1,4 @@
-#include "seal_private.h"
+#include "private.h"
 
 os_stack_t *os_port_init_stack(os_task_func_t entry_func, os_stack_t *stack_ptr,
                                os_stack_t stack_size, void *param) {
@@ -20,20 +20,51 @@ os_stack_t *os_port_init_stack(os_task_func_t entry_func, os_stack_t *stack_ptr,
   *(--ptr) = (os_stack_t)0x00000006UL;                          /* R6 */
   *(--ptr) = (os_stack_t)0x00000005UL;                          /* R5 */
   *(--ptr) = (os_stack_t)0x00000004UL;                          /* R4 */
-  os_stack_t *ret = ptr;
-  while (ptr-- != stack_ptr) {
-    *ptr = 0xdeadbeef;
-  }
-  return ret;
+  return ptr;
+}
+
+#if OS_CFG_STACK_FILL == OS_STACK_FILL_IDLE
+os_stack_t *os_port_stack_free(const os_tcb_t *task, os_stack_t **bottom) {
+  OS_UNUSED(bottom);
+  return task->stack_ptr;
 }
+#endif
 
 static os_stack_t os_exception_stack[256];
 
+#if !OS_PORT_USE_DWT_CYCCNT
+/** @brief Amount of handled systicks, used to extend the SysTick counter. */
+static volatile os_u32_t os_port_tick_cnt = 0;
+#endif
+
+#if OS_CFG_ENABLE_TICKLESS_IDLE
+/** @brief SysTick counts per systick, captured before the first suppression. */
+static os_reg_t os_port_tick_reload = 0;
+/** @brief SysTick control bits, written whole to stop the counter without
+ * reading COUNTFLAG, which clears it. */
+static os_reg_t os_port_tick_ctrl = 0;
+#endif
+
 void os_port_startup(void) {
   OS_DISABLE_INTERRUPTS();
 
   os_curr_task = os_next_task;
   OS_PORT_NVIC_PENDSV_PRIO_REG = OS_PORT_NVIC_PENDSV_PRIO_VAL;
+#if OS_CFG_ENABLE_TICKLESS_IDLE
+  os_port_tick_reload = OS_PORT_SYSTICK_LOAD_REG + 1;
+  os_port_tick_ctrl = OS_PORT_SYSTICK_CTRL_REG & ~OS_PORT_SYSTICK_COUNTFLAG_BIT;
+#endif
+#if OS_CFG_ENABLE_STACK_GUARD
+  /* os_port_stack_guard() has already placed the region */
+  OS_PORT_MPU_RNR_REG = OS_PORT_MPU_GUARD_REGION;
+  OS_PORT_MPU_RASR_REG = OS_PORT_MPU_RASR_GUARD_VAL;
+  OS_PORT_MPU_CTRL_REG =
+      OS_PORT_MPU_CTRL_PRIVDEFENA_BIT | OS_PORT_MPU_CTRL_ENABLE_BIT;
+  OS_PORT_SHCSR_REG |= OS_PORT_SHCSR_MEMFAULTENA_BIT;
+  __asm volatile("dsb \n"
+                 "isb \n" ::
+                     : "memory");
+#endif
   os_ctx.is_running = OS_TRUE;
 
   /* get top of stack and align to 8 bytes */
@@ -68,8 +99,127 @@ void os_port_startup(void) {
       : "memory");
 }
 
+#if OS_CFG_ENABLE_STACK_GUARD
+/*
+ * The PendSV exception return synchronizes the new region with the incoming
+ * task, so a single store needs no barriers.
+ */
+void os_port_stack_guard(os_stack_t *guard) {
+  OS_PORT_MPU_RBAR_REG =
+      (os_reg_t)guard | OS_PORT_MPU_RBAR_VALID_BIT | OS_PORT_MPU_GUARD_REGION;
+}
+
+void os_port_memmanage_handler(void) {
+  /* besides the guard, only fetches from execute never memory can fault */
+  if (OS_PORT_MMFSR_REG & OS_PORT_MMFSR_IACCVIOL_BIT) {
+    os_panic(OS_ERROR);
+  }
+  os_panic(OS_STACK_OVERFLOW);
+}
+#endif
+
 void os_port_systick_handler(void) {
+#if !OS_PORT_USE_DWT_CYCCNT
+  os_port_tick_cnt++;
+#endif
   os_enter_isr();
   os_systick();
   os_exit_isr();
 }
+
+void os_port_cycle_counter_init(void) {
+#if OS_PORT_USE_DWT_CYCCNT
+  OS_PORT_DEMCR_REG |= OS_PORT_DEMCR_TRCENA_BIT;
+  OS_PORT_DWT_CYCCNT_REG = 0;
+  OS_PORT_DWT_CTRL_REG |= OS_PORT_DWT_CYCCNTENA_BIT;
+#endif
+}
+
+os_u32_t os_port_get_cycles(void) {
+#if OS_PORT_USE_DWT_CYCCNT
+  return OS_PORT_DWT_CYCCNT_REG;
+#else
+  os_u32_t ticks;
+  os_reg_t val;
+  os_reg_t pending;
+#if OS_CFG_ENABLE_TICKLESS_IDLE
+  /* LOAD holds a stretched period while the idle task sleeps */
+  os_reg_t reload = (os_port_tick_reload != 0) ? os_port_tick_reload
+                                               : OS_PORT_SYSTICK_LOAD_REG + 1;
+#else
+  os_reg_t reload = OS_PORT_SYSTICK_LOAD_REG + 1;
+#endif
+  do {
+    ticks = os_port_tick_cnt;
+    val = OS_PORT_SYSTICK_VAL_REG;
+    /* with interrupts masked the counter may have wrapped without the
+     * handler running yet, then VAL is read again past the wrap */
+    pending = OS_PORT_NVIC_INT_CTRL_REG & OS_PORT_NVIC_PENDSTSET_BIT;
+    if (pending) {
+      val = OS_PORT_SYSTICK_VAL_REG;
+    }
+  } while (ticks != os_port_tick_cnt);
+  if (pending) {
+    ticks++;
+  }
+  return (ticks * reload) + (reload - 1 - val);
+#endif
+}
+
+#if OS_CFG_ENABLE_TICKLESS_IDLE
+void os_port_tickless_idle(void) {
+  OS_DISABLE_INTERRUPTS();
+  os_size_t ticks = os_idle_ticks();
+  if (ticks == 0) {
+    OS_ENABLE_INTERRUPTS();
+    return;
+  }
+  if (ticks > OS_PORT_SYSTICK_MAX_LOAD / os_port_tick_reload) {
+    ticks = OS_PORT_SYSTICK_MAX_LOAD / os_port_tick_reload;
+  }
+
+  /* stop the SysTick and stretch the current tick over the idle period */
+  OS_PORT_SYSTICK_CTRL_REG &= ~OS_PORT_SYSTICK_ENABLE_BIT;
+  os_reg_t remaining = OS_PORT_SYSTICK_VAL_REG;
+  os_reg_t idle_load = remaining + (ticks - 1) * os_port_tick_reload;
+  OS_PORT_SYSTICK_LOAD_REG = idle_load;
+  OS_PORT_SYSTICK_VAL_REG = 0;
+  OS_PORT_SYSTICK_CTRL_REG |= OS_PORT_SYSTICK_ENABLE_BIT;
+
+  __asm volatile("dsb \n"
+                 "wfi \n"
+                 "isb \n" ::
+                     : "memory");
+
+  /* stop the counter first, so it can't wrap between the samples below */
+  OS_PORT_SYSTICK_CTRL_REG = os_port_tick_ctrl & ~OS_PORT_SYSTICK_ENABLE_BIT;
+  os_reg_t ctrl = OS_PORT_SYSTICK_CTRL_REG;
+  os_reg_t counted = idle_load - OS_PORT_SYSTICK_VAL_REG;
+  os_size_t elapsed;
+  if (ctrl & OS_PORT_SYSTICK_COUNTFLAG_BIT) {
+    /* the pending SysTick handler accounts for the last tick, counted is
+     * how far the counter got into the next one */
+    elapsed = ticks - 1;
+  } else {
+    /* woken up early by another interrupt */
+    counted += os_port_tick_reload - remaining;
+    elapsed = 0;
+  }
+  elapsed += counted / os_port_tick_reload;
+  os_reg_t partial = counted % os_port_tick_reload;
+#if !OS_PORT_USE_DWT_CYCCNT
+  /* the handler counted none of the suppressed ticks */
+  os_port_tick_cnt += elapsed;
+#endif
+
+  /* finish the current tick, then resume the regular period */
+  OS_PORT_SYSTICK_LOAD_REG = os_port_tick_reload - partial - 1;
+  OS_PORT_SYSTICK_VAL_REG = 0;
+  OS_PORT_SYSTICK_CTRL_REG |= OS_PORT_SYSTICK_ENABLE_BIT;
+  OS_PORT_SYSTICK_LOAD_REG = os_port_tick_reload - 1;
+
+  os_systick_advance(elapsed);
+  OS_ENABLE_INTERRUPTS();
+  os_schedule();
+}
+#endif
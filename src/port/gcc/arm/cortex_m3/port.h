@@ -26,11 +26,30 @@ typedef os_u32_t os_reg_t;
 typedef os_u32_t os_size_t;
 typedef os_u32_t os_stack_t;
 
+#ifndef OS_PORT_USE_DWT_CYCCNT
+#define OS_PORT_USE_DWT_CYCCNT 1U
+#endif
+
 /**
  * @brief This macro converts _bytes to an amount of os_stack_t entries.
  */
 #define OS_PORT_BYTES_TO_SECTORS(_bytes) (_bytes >> 2)
 
+/**
+ * @brief Size of the MPU region that guards the running task's stack with
+ * OS_CFG_ENABLE_STACK_GUARD, the smallest one that ARMv7-M supports.
+ */
+#define OS_PORT_STACK_GUARD_SIZE 32U
+
+/**
+ * @brief Orders memory accesses, e.g. between a producer and a consumer
+ * that don't share a critical section.
+ */
+#define OS_MEMORY_BARRIER()                                                    \
+  do {                                                                         \
+    __asm volatile("dmb" ::: "memory");                                        \
+  } while (0)
+
 #define OS_DISABLE_INTERRUPTS()                                                \
   do {                                                                         \
     __asm volatile("cpsid i" ::: "memory");                                    \
@@ -71,19 +90,44 @@ typedef os_u32_t os_stack_t;
     os_port_exit_critical(os_critical);                                        \
   } while (0)
 
+#define OS_PORT_MAX_SYSCALL_INT_PRIORITY 4U
+#define OS_PORT_NVIC_OFFSET 4U
+#define OS_PORT_BASEPRI_VAL                                                    \
+  (OS_PORT_MAX_SYSCALL_INT_PRIORITY << OS_PORT_NVIC_OFFSET)
+
 /**
  * @brief This function is specific to this port of osrtos. Use
  * OS_ENTER_CRITICAL() for better portability.
+ * @note The isb makes the new basepri apply to the very next instruction.
+ * Neither a dsb nor masking with cpsid around the write is needed, the latter
+ * only works around an erratum of early Cortex-M7 revisions.
  * @return os_reg_t - value of basepri upon entering the critical section
  */
-os_reg_t os_port_enter_critical();
+static inline os_reg_t os_port_enter_critical(void) {
+  os_reg_t basepri;
+  __asm volatile("mrs %0, basepri\n\t"
+                 "msr basepri, %1\n\t"
+                 "isb"
+                 : "=&r"(basepri)
+                 : "r"((os_reg_t)OS_PORT_BASEPRI_VAL)
+                 : "memory");
+  return basepri;
+}
 
 /**
  * @brief This function is specific to this port of osrtos. Use
  * OS_EXIT_CRITICAL() for better portability.
+ * @note The isb makes a PendSV requested inside the critical section fire
+ * before the caller goes on, e.g. before a blocked task reads its wait result.
  * @param new_basepri - value of basepri to restore
  */
-void os_port_exit_critical(os_reg_t new_basepri);
+static inline void os_port_exit_critical(os_reg_t new_basepri) {
+  __asm volatile("msr basepri, %0\n\t"
+                 "isb"
+                 :
+                 : "r"(new_basepri)
+                 : "memory");
+}
 
 /**
  * @brief SysTick handler used by osrtos.
@@ -94,6 +138,38 @@ void os_port_exit_critical(os_reg_t new_basepri);
  */
 void os_port_systick_handler(void);
 
+/**
+ * @brief Puts the CPU to sleep with the SysTick suppressed until the nearest
+ * timeout, then catches up the elapsed ticks.
+ *
+ * It's called by the idle task when OS_CFG_ENABLE_TICKLESS_IDLE is set.
+ */
+void os_port_tickless_idle(void);
+
+/**
+ * @brief Starts the free-running counter read by os_port_get_cycles().
+ */
+void os_port_cycle_counter_init(void);
+
+/**
+ * @brief Reads the free-running cycle counter.
+ *
+ * It's the DWT cycle counter, unless OS_PORT_USE_DWT_CYCCNT is set to 0 (e.g.
+ * for QEMU, which doesn't model the DWT). Then the count is derived from the
+ * SysTick and the amount of handled systicks, at the SysTick clock rate.
+ * @return os_u32_t - current count, wrapping around at 2^32
+ */
+os_u32_t os_port_get_cycles(void);
+
+/**
+ * @brief MemManage handler used by osrtos.
+ *
+ * It's needed with OS_CFG_ENABLE_STACK_GUARD. A task that hits the stack guard
+ * causes a kernel panic with OS_STACK_OVERFLOW, any other MemManage fault one
+ * with OS_ERROR.
+ */
+void os_port_memmanage_handler(void);
+
 /**
  * @brief PendSV handler used by osrtos.
  *
@@ -1,10 +1,9 @@
 .extern  os_curr_task
 .extern  os_next_task
+.weak    os_switch_hook
 
 .global  os_port_pendsv_handler
 .global  os_port_context_switch
-.global  os_port_enter_critical
-.global  os_port_exit_critical
 
 .equ OS_PORT_NVIC_INT_CTRL_REG,     0xE000ED04
 .equ OS_PORT_NVIC_PENDSVSET_BIT,    0x10000000
@@ -24,29 +23,6 @@ os_port_context_switch:
     isb
     bx lr
 
-.thumb_func
-os_port_enter_critical:
-    cpsid i
-    push {r1}
-    ldr r0, =OS_PORT_BASEPRI_VAL
-    mrs r1, basepri
-    msr basepri, r0
-    dsb
-    isb
-    mov r0, r1
-    pop {r1}
-    cpsie i
-    bx lr
-
-.thumb_func
-os_port_exit_critical:
-    cpsid i
-    msr basepri, r0
-    dsb
-    isb
-    cpsie i
-    bx lr
-
 .thumb_func
 os_port_pendsv_handler:
     cpsid i                  /* disable interrupts */
@@ -63,6 +39,13 @@ os_port_pendsv_handler:
     ldr r2, [r1]             /* get address of current task and stack pointer */
     str r0, [r2]             /* store stack pointer to current task */
 
+    ldr r3, =os_switch_hook  /* account the switch, if it's compiled in */
+    cbz r3, 1f
+    push {r1, lr}
+    blx r3                   /* r0 still holds the old stack pointer */
+    pop {r1, lr}
+1:
+
     ldr r3, =os_next_task    /* get address of next taskptr */
     ldr r2, [r3]             /* get address of next task and stack pointer */
     str r2, [r1]             /* set next task as current task */
@@ -0,0 +1,72 @@
+.extern  os_curr_task
+.extern  os_next_task
+.weak    os_switch_hook
+
+.global  os_port_pendsv_handler
+.global  os_port_context_switch
+
+.equ OS_PORT_NVIC_INT_CTRL_REG,     0xE000ED04
+.equ OS_PORT_NVIC_PENDSVSET_BIT,    0x10000000
+.equ OS_PORT_BASEPRI_VAL,           0x40
+
+.text
+.align 4
+.thumb
+.syntax unified
+.fpu fpv4-sp-d16
+
+.thumb_func
+os_port_context_switch:
+    ldr r0, =OS_PORT_NVIC_INT_CTRL_REG
+    ldr r1, =OS_PORT_NVIC_PENDSVSET_BIT
+    str r1, [r0]
+    dsb
+    isb
+    bx lr
+
+.thumb_func
+os_port_pendsv_handler:
+    cpsid i                  /* disable interrupts */
+    ldr r0, =OS_PORT_BASEPRI_VAL
+    msr basepri, r0
+    dsb
+    isb
+    cpsie i
+
+    mrs r0, psp              /* load old process stack pointer */
+    tst lr, #0x10            /* EXC_RETURN[4] == 0: the task used the FPU */
+    it eq
+    vstmdbeq r0!, {s16-s31}  /* push FPU registers, s0-s15 are lazy stacked */
+    stmdb r0!, {r4-r11, lr}  /* push registers and EXC_RETURN */
+
+    ldr r1, =os_curr_task    /* get address of current taskptr */
+    ldr r2, [r1]             /* get address of current task and stack pointer */
+    str r0, [r2]             /* store stack pointer to current task */
+
+    ldr r3, =os_switch_hook  /* account the switch, if it's compiled in */
+    cbz r3, 1f
+    push {r1, lr}
+    blx r3                   /* r0 still holds the old stack pointer */
+    pop {r1, lr}
+1:
+
+    ldr r3, =os_next_task    /* get address of next taskptr */
+    ldr r2, [r3]             /* get address of next task and stack pointer */
+    str r2, [r1]             /* set next task as current task */
+
+    ldr r0, [r2]             /* get value of next stack pointer */
+    ldmia r0!, {r4-r11, lr}  /* pop registers and EXC_RETURN */
+    tst lr, #0x10            /* EXC_RETURN[4] == 0: the task used the FPU */
+    it eq
+    vldmiaeq r0!, {s16-s31}  /* pop FPU registers */
+    msr psp, r0              /* load new process stack pointer */
+
+    cpsid i                  /* enable interrupts */
+    mov r0, #0
+    msr basepri, r0
+    dsb
+    isb
+    cpsie i
+    bx lr
+
+.end
@@ -0,0 +1,62 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OS_PORT_NVIC_PENDSV_PRIO_REG *((volatile os_reg_t *)0xe000ed22)
+#define OS_PORT_NVIC_PENDSV_PRIO_VAL (0xff)
+#define OS_PORT_NVIC_INT_CTRL_REG *((volatile os_reg_t *)0xe000ed04)
+#define OS_PORT_NVIC_PENDSVSET_BIT (1UL << 28UL)
+#define OS_PORT_NVIC_PENDSTSET_BIT (1UL << 26UL)
+
+#define OS_PORT_SYSTICK_CTRL_REG *((volatile os_reg_t *)0xe000e010)
+#define OS_PORT_SYSTICK_LOAD_REG *((volatile os_reg_t *)0xe000e014)
+#define OS_PORT_SYSTICK_VAL_REG *((volatile os_reg_t *)0xe000e018)
+#define OS_PORT_SYSTICK_ENABLE_BIT (1UL << 0UL)
+#define OS_PORT_SYSTICK_COUNTFLAG_BIT (1UL << 16UL)
+#define OS_PORT_SYSTICK_MAX_LOAD (0x00ffffffUL)
+
+#define OS_PORT_DEMCR_REG *((volatile os_reg_t *)0xe000edfc)
+#define OS_PORT_DEMCR_TRCENA_BIT (1UL << 24UL)
+#define OS_PORT_DWT_CTRL_REG *((volatile os_reg_t *)0xe0001000)
+#define OS_PORT_DWT_CYCCNT_REG *((volatile os_reg_t *)0xe0001004)
+#define OS_PORT_DWT_CYCCNTENA_BIT (1UL << 0UL)
+
+#define OS_PORT_CPACR_REG *((volatile os_reg_t *)0xe000ed88)
+#define OS_PORT_CPACR_CP10_CP11_FULL (0xfUL << 20UL)
+#define OS_PORT_FPCCR_REG *((volatile os_reg_t *)0xe000ef34)
+#define OS_PORT_FPCCR_ASPEN_BIT (1UL << 31UL)
+#define OS_PORT_FPCCR_LSPEN_BIT (1UL << 30UL)
+
+#define OS_PORT_SHCSR_REG *((volatile os_reg_t *)0xe000ed24)
+#define OS_PORT_SHCSR_MEMFAULTENA_BIT (1UL << 16UL)
+#define OS_PORT_MMFSR_REG *((volatile os_u8_t *)0xe000ed28)
+#define OS_PORT_MMFSR_IACCVIOL_BIT (1U << 0U)
+
+#define OS_PORT_MPU_CTRL_REG *((volatile os_reg_t *)0xe000ed94)
+#define OS_PORT_MPU_CTRL_ENABLE_BIT (1UL << 0UL)
+#define OS_PORT_MPU_CTRL_PRIVDEFENA_BIT (1UL << 2UL)
+#define OS_PORT_MPU_RNR_REG *((volatile os_reg_t *)0xe000ed98)
+#define OS_PORT_MPU_RBAR_REG *((volatile os_reg_t *)0xe000ed9c)
+#define OS_PORT_MPU_RBAR_VALID_BIT (1UL << 4UL)
+#define OS_PORT_MPU_RASR_REG *((volatile os_reg_t *)0xe000eda0)
+/* execute never, no access, 2^(4 + 1) bytes, enabled */
+#define OS_PORT_MPU_RASR_GUARD_VAL ((1UL << 28UL) | (4UL << 1UL) | 1UL)
+/* the highest region takes precedence over any regions of the application */
+#define OS_PORT_MPU_GUARD_REGION 7UL
+
+#define OS_CTX_SWITCH() os_port_context_switch()
+#define OS_CTX_SWITCH_FROM_ISR() os_port_context_switch()
+
+/** @brief This function triggers PendSV. */
+void os_port_context_switch(void);
+
+/**
+ * @brief Gets the index of the highest set bit of a non-zero 32-bit word.
+ */
+#define OS_GET_HIGHEST_PRIORITY(_priorities) (31UL - __builtin_clz(_priorities))
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,207 @@
+/* for REG_RSP and REG_ESP in <ucontext.h> */
+#define _GNU_SOURCE
+
+#include "private.h"
+
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <ucontext.h>
+
+/**
+ * @brief Task context, kept at the bottom of each task's stack.
+ */
+typedef struct {
+  ucontext_t context;
+  os_task_func_t entry_func;
+  void *param;
+} os_port_task_t;
+
+#define OS_PORT_TASK(_tcb) ((os_port_task_t *)(_tcb)->stack_ptr)
+
+#if OS_CFG_STACK_FILL == OS_STACK_FILL_IDLE
+/**
+ * @brief Stack pointer that swapcontext() or makecontext() saved in a task
+ * context. Nothing below it is in use while the task is switched out.
+ */
+#if defined(__x86_64__)
+#define OS_PORT_CONTEXT_SP(_context) ((_context)->uc_mcontext.gregs[REG_RSP])
+#elif defined(__i386__)
+#define OS_PORT_CONTEXT_SP(_context) ((_context)->uc_mcontext.gregs[REG_ESP])
+#elif defined(__aarch64__)
+#define OS_PORT_CONTEXT_SP(_context) ((_context)->uc_mcontext.sp)
+#else
+#error OS_STACK_FILL_IDLE is not supported on this host
+#endif
+#endif
+
+static volatile os_bool_t os_port_switch_pending = OS_FALSE;
+
+#if OS_CFG_ENABLE_TICKLESS_IDLE
+/**
+ * @brief Monotonic time of the last systick accounted for, in nanoseconds.
+ */
+static os_u64_t os_port_tick_ns;
+
+static os_u64_t _now_ns(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (os_u64_t)now.tv_sec * 1000000000ULL + (os_u64_t)now.tv_nsec;
+}
+#endif
+
+/**
+ * @brief   Switches from @c os_curr_task to @c os_next_task. It's kept out of
+ *          line, so that its frame lies below the locals of its callers.
+ * @note    Call this with the systick signal blocked.
+ */
+static __attribute__((noinline)) void _switch(void) {
+  os_tcb_t *prev = os_curr_task;
+  os_port_switch_pending = OS_FALSE;
+#if OS_SWITCH_HOOK
+  /* this still runs on the stack of the outgoing task */
+  os_switch_hook((os_stack_t *)__builtin_frame_address(0));
+#endif
+  os_curr_task = os_next_task;
+  if (prev != os_curr_task) {
+    swapcontext(&OS_PORT_TASK(prev)->context,
+                &OS_PORT_TASK(os_curr_task)->context);
+  }
+}
+
+/**
+ * @brief Entry point of every task context.
+ */
+static void _task_start(void) {
+  OS_PORT_TASK(os_curr_task)->entry_func(OS_PORT_TASK(os_curr_task)->param);
+  os_task_exit();
+}
+
+static void _signal_handler(int signal) {
+  OS_UNUSED(signal);
+  os_port_systick_handler();
+}
+
+os_stack_t *os_port_init_stack(os_task_func_t entry_func, os_stack_t *stack_ptr,
+                               os_stack_t stack_size, void *param) {
+  /* align to 16 bytes */
+  unsigned long base = ((unsigned long)stack_ptr + 15UL) & ~15UL;
+  unsigned long top = (unsigned long)&stack_ptr[stack_size] & ~15UL;
+  os_port_task_t *task = (os_port_task_t *)base;
+  base += (sizeof(os_port_task_t) + 15UL) & ~15UL;
+  OS_ASSERT((base < top), OS_ERROR);
+
+  /* getcontext() leaves parts of it as they are, i.e. with the fill pattern */
+  memset(task, 0, sizeof(os_port_task_t));
+  task->entry_func = entry_func;
+  task->param = param;
+  getcontext(&task->context);
+  task->context.uc_stack.ss_sp = (void *)base;
+  task->context.uc_stack.ss_size = top - base;
+  task->context.uc_link = OS_NULL;
+  sigemptyset(&task->context.uc_sigmask);
+  makecontext(&task->context, _task_start, 0);
+  return (os_stack_t *)task;
+}
+
+#if OS_CFG_STACK_FILL == OS_STACK_FILL_IDLE
+os_stack_t *os_port_stack_free(const os_tcb_t *task, os_stack_t **bottom) {
+  *bottom = (os_stack_t *)(OS_PORT_TASK(task) + 1);
+  return (os_stack_t *)OS_PORT_CONTEXT_SP(&OS_PORT_TASK(task)->context);
+}
+#endif
+
+void os_port_startup(void) {
+  OS_DISABLE_INTERRUPTS();
+
+  os_curr_task = os_next_task;
+  os_ctx.is_running = OS_TRUE;
+
+  struct sigaction action = {0};
+  action.sa_handler = _signal_handler;
+  action.sa_flags = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  sigaddset(&action.sa_mask, SIGALRM);
+  sigaction(SIGALRM, &action, OS_NULL);
+
+  struct itimerval timer = {0};
+#if OS_CFG_ENABLE_TICKLESS_IDLE
+  os_port_tick_ns = _now_ns();
+#endif
+  timer.it_interval.tv_usec = OS_PORT_TICK_PERIOD_US;
+  timer.it_value.tv_usec = OS_PORT_TICK_PERIOD_US;
+  setitimer(ITIMER_REAL, &timer, OS_NULL);
+
+  setcontext(&OS_PORT_TASK(os_curr_task)->context);
+}
+
+void os_port_context_switch(void) { os_port_switch_pending = OS_TRUE; }
+
+os_reg_t os_port_enter_critical(void) {
+  sigset_t set;
+  sigset_t old_set;
+  sigemptyset(&set);
+  sigaddset(&set, SIGALRM);
+  sigprocmask(SIG_BLOCK, &set, &old_set);
+  return sigismember(&old_set, SIGALRM) ? OS_TRUE : OS_FALSE;
+}
+
+void os_port_exit_critical(os_reg_t was_blocked) {
+  if (was_blocked) {
+    return;
+  }
+  if (os_port_switch_pending) {
+    _switch();
+  }
+  sigset_t set;
+  sigemptyset(&set);
+  sigaddset(&set, SIGALRM);
+  sigprocmask(SIG_UNBLOCK, &set, OS_NULL);
+}
+
+void os_port_systick_handler(void) {
+  os_enter_isr();
+#if OS_CFG_ENABLE_TICKLESS_IDLE
+  /*
+   * The process sleeps between the signals, and the host merges the ones that
+   * come due while it isn't scheduled. The ticks are counted from the clock,
+   * and a signal that was already counted is skipped.
+   */
+  os_size_t ticks = (os_size_t)((_now_ns() - os_port_tick_ns) /
+                                (OS_PORT_TICK_PERIOD_US * 1000ULL));
+  os_port_tick_ns += (os_u64_t)ticks * OS_PORT_TICK_PERIOD_US * 1000ULL;
+  if (ticks != 0) {
+    os_systick();
+  }
+  if (ticks > 1) {
+    os_systick_advance(ticks - 1);
+  }
+#else
+  os_systick();
+#endif
+  os_exit_isr();
+  if (os_port_switch_pending) {
+    _switch();
+  }
+}
+
+void os_port_cycle_counter_init(void) {}
+
+os_u32_t os_port_get_cycles(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (os_u32_t)((os_u64_t)now.tv_sec * 1000000000ULL +
+                    (os_u64_t)now.tv_nsec);
+}
+
+void os_port_tickless_idle(void) {
+  OS_DECLARE_CRITICAL();
+  OS_ENTER_CRITICAL();
+  if (os_idle_ticks() != 0) {
+    sigset_t set;
+    sigemptyset(&set);
+    sigsuspend(&set);
+  }
+  OS_EXIT_CRITICAL();
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OS_TRUE 1U
+#define OS_FALSE 0U
+#define OS_NULL ((void *)0)
+
+typedef unsigned char os_bool_t;
+
+typedef unsigned char os_u8_t;
+typedef unsigned short int os_u16_t;
+typedef unsigned int os_u32_t;
+typedef unsigned long long int os_u64_t;
+typedef signed char os_i8_t;
+typedef signed short int os_i16_t;
+typedef signed int os_i32_t;
+typedef signed long long int os_i64_t;
+
+typedef float os_f32_t;
+typedef double os_f64_t;
+
+typedef os_u32_t os_reg_t;
+typedef os_u32_t os_size_t;
+typedef os_u32_t os_stack_t;
+
+/**
+ * @brief Stack sizes in config.h are meant for the target, host code needs
+ * much bigger stacks, so they are multiplied by this factor.
+ */
+#define OS_PORT_STACK_SCALE 128U
+
+/**
+ * @brief Systick period of the simulation [in microseconds].
+ */
+#define OS_PORT_TICK_PERIOD_US 1000U
+
+/**
+ * @brief This macro converts _bytes to an amount of os_stack_t entries.
+ */
+#define OS_PORT_BYTES_TO_SECTORS(_bytes)                                       \
+  (((_bytes) * OS_PORT_STACK_SCALE) / sizeof(os_stack_t))
+
+/**
+ * @brief Orders memory accesses, e.g. between a producer and a consumer
+ * that don't share a critical section.
+ */
+#define OS_MEMORY_BARRIER()                                                    \
+  do {                                                                         \
+    __sync_synchronize();                                                      \
+  } while (0)
+
+/**
+ * @brief In this port the systick signal plays the role of interrupts.
+ */
+#define OS_DISABLE_INTERRUPTS()                                                \
+  do {                                                                         \
+    os_port_enter_critical();                                                  \
+  } while (0)
+
+#define OS_ENABLE_INTERRUPTS()                                                 \
+  do {                                                                         \
+    os_port_exit_critical(OS_FALSE);                                           \
+  } while (0)
+
+/**
+ * @brief Call this macro at the entry of each function that has any critical
+ * sections.
+ */
+#define OS_DECLARE_CRITICAL() os_reg_t os_critical = 0;
+
+/**
+ * @brief   Call this macro to enter a critical section.
+ * @note    It requires OS_DECLARE_CRITICAL() to be called at the entry of the
+ * function.
+ */
+#define OS_ENTER_CRITICAL()                                                    \
+  do {                                                                         \
+    os_critical = os_port_enter_critical();                                    \
+  } while (0)
+
+/**
+ * @brief   Call this macro to exit a critical section.
+ * @note    It requires OS_DECLARE_CRITICAL() to be called at the entry of the
+ * function.
+ */
+#define OS_EXIT_CRITICAL()                                                     \
+  do {                                                                         \
+    os_port_exit_critical(os_critical);                                        \
+  } while (0)
+
+/**
+ * @brief This function is specific to this port of osrtos. Use
+ * OS_ENTER_CRITICAL() for better portability.
+ * @return os_reg_t - OS_TRUE if the systick signal was already blocked
+ */
+os_reg_t os_port_enter_critical(void);
+
+/**
+ * @brief This function is specific to this port of osrtos. Use
+ * OS_EXIT_CRITICAL() for better portability.
+ *
+ * Leaving the outermost critical section performs a pending context switch,
+ * the same way PendSV fires once BASEPRI is lowered on Cortex-M.
+ * @param was_blocked - value returned by the matching os_port_enter_critical()
+ */
+void os_port_exit_critical(os_reg_t was_blocked);
+
+/**
+ * @brief SysTick handler used by osrtos.
+ *
+ * It's installed as the SIGALRM handler by os_port_startup().
+ */
+void os_port_systick_handler(void);
+
+/**
+ * @brief Starts the free-running counter read by os_port_get_cycles().
+ */
+void os_port_cycle_counter_init(void);
+
+/**
+ * @brief Reads the free-running counter. In this port it counts nanoseconds
+ * of the monotonic clock.
+ * @return os_u32_t - current count, wrapping around at 2^32
+ */
+os_u32_t os_port_get_cycles(void);
+
+/**
+ * @brief Waits for the next systick signal instead of spinning.
+ *
+ * It's called by the idle task when OS_CFG_ENABLE_TICKLESS_IDLE is set. The
+ * interval timer keeps running, so ticks aren't suppressed in this port. The
+ * systick handler then counts the elapsed ticks from the monotonic clock, as
+ * the host may merge the signals that come due while the process sleeps.
+ */
+void os_port_tickless_idle(void);
+
+#ifdef __cplusplus
+}
+#endif
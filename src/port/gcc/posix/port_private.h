@@ -0,0 +1,20 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OS_CTX_SWITCH() os_port_context_switch()
+#define OS_CTX_SWITCH_FROM_ISR() os_port_context_switch()
+
+/** @brief This function pends a context switch. */
+void os_port_context_switch(void);
+
+/**
+ * @brief Gets the index of the highest set bit of a non-zero 32-bit word.
+ */
+#define OS_GET_HIGHEST_PRIORITY(_priorities) (31UL - __builtin_clz(_priorities))
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,139 @@
+#include "private.h"
+
+os_stack_t *os_port_init_stack(os_task_func_t entry_func, os_stack_t *stack_ptr,
+                               os_stack_t stack_size, void *param) {
+  os_stack_t *ptr = &stack_ptr[stack_size];
+  ptr = (os_stack_t *)((os_stack_t)(ptr)&0xfffffff0U); /* align to 16 bytes */
+  ptr -= OS_PORT_FRAME_WORDS;
+  for (os_size_t i = 0; i < OS_PORT_FRAME_WORDS; i++) {
+    ptr[i] = 0;
+  }
+  ptr[OS_PORT_FRAME_RA] = (os_stack_t)os_task_exit;
+  ptr[OS_PORT_FRAME_A0] = (os_stack_t)param;
+  ptr[OS_PORT_FRAME_MEPC] = (os_stack_t)entry_func;
+  /* machine mode, interrupts enabled by mret */
+  ptr[OS_PORT_FRAME_MSTATUS] = OS_PORT_MSTATUS_MPP_M | OS_PORT_MSTATUS_MPIE_BIT;
+  return ptr;
+}
+
+#if OS_CFG_STACK_FILL == OS_STACK_FILL_IDLE
+os_stack_t *os_port_stack_free(const os_tcb_t *task, os_stack_t **bottom) {
+  OS_UNUSED(bottom);
+  return task->stack_ptr;
+}
+#endif
+
+__attribute__((aligned(16))) static os_stack_t os_port_trap_stack[256];
+
+/** @brief Top of the stack used by the trap handler. */
+os_stack_t *const os_port_trap_stack_top =
+    &os_port_trap_stack[OS_ARRAY_SIZE(os_port_trap_stack)];
+
+/** @brief mtime of the next systick. */
+static os_u64_t os_port_next_tick = 0;
+
+static os_u64_t _get_mtime(void) {
+  os_u32_t hi;
+  os_u32_t lo;
+  do {
+    hi = OS_PORT_CLINT_MTIME_HI_REG;
+    lo = OS_PORT_CLINT_MTIME_LO_REG;
+  } while (hi != OS_PORT_CLINT_MTIME_HI_REG);
+  return ((os_u64_t)hi << 32) | lo;
+}
+
+/**
+ * @brief   Sets the timer compare value without a spurious match in between
+ *          the two halves.
+ */
+static void _set_mtimecmp(os_u64_t value) {
+  OS_PORT_CLINT_MTIMECMP_HI_REG = 0xffffffffUL;
+  OS_PORT_CLINT_MTIMECMP_LO_REG = (os_u32_t)value;
+  OS_PORT_CLINT_MTIMECMP_HI_REG = (os_u32_t)(value >> 32);
+}
+
+void os_port_context_switch(void) { OS_PORT_CLINT_MSIP_REG = 1; }
+
+void os_port_startup(void) {
+  OS_DISABLE_INTERRUPTS();
+
+  os_curr_task = os_next_task;
+  os_ctx.is_running = OS_TRUE;
+
+  __asm volatile("csrw mtvec, %0" ::"r"(os_port_trap_handler));
+  OS_PORT_CLINT_MSIP_REG = 0;
+  os_port_next_tick = _get_mtime() + OS_PORT_TICK_PERIOD;
+  _set_mtimecmp(os_port_next_tick);
+  __asm volatile("csrs mie, %0" ::"r"(OS_PORT_MIE_MTIE_BIT |
+                                      OS_PORT_MIE_MSIE_BIT));
+
+  os_port_restore_context();
+}
+
+/**
+ * @brief   Machine timer interrupt, i.e. the systick.
+ */
+static void _systick_handler(void) {
+  os_port_next_tick += OS_PORT_TICK_PERIOD;
+  _set_mtimecmp(os_port_next_tick);
+  os_enter_isr();
+  os_systick();
+  os_exit_isr();
+}
+
+void os_port_trap(os_reg_t mcause) {
+  switch (mcause) {
+  case OS_PORT_MCAUSE_MTI:
+    _systick_handler();
+    break;
+  case OS_PORT_MCAUSE_MSI:
+    break;
+  default:
+    os_panic(OS_ERROR);
+  }
+  /* a switch requested by this very trap is performed right away */
+  if (OS_PORT_CLINT_MSIP_REG) {
+    OS_PORT_CLINT_MSIP_REG = 0;
+#if OS_SWITCH_HOOK
+    os_switch_hook(os_curr_task->stack_ptr);
+#endif
+    os_curr_task = os_next_task;
+  }
+}
+
+void os_port_cycle_counter_init(void) {}
+
+os_u32_t os_port_get_cycles(void) {
+  os_u32_t cycles;
+  __asm volatile("csrr %0, mcycle" : "=r"(cycles));
+  return cycles;
+}
+
+#if OS_CFG_ENABLE_TICKLESS_IDLE
+void os_port_tickless_idle(void) {
+  OS_DISABLE_INTERRUPTS();
+  os_size_t ticks = os_idle_ticks();
+  if (ticks == 0) {
+    OS_ENABLE_INTERRUPTS();
+    return;
+  }
+
+  /* the regular tick at os_port_next_tick is the first of the idle period */
+  _set_mtimecmp(os_port_next_tick +
+                ((os_u64_t)(ticks - 1) * OS_PORT_TICK_PERIOD));
+  __asm volatile("wfi" ::: "memory");
+
+  os_u64_t now = _get_mtime();
+  if (now >= os_port_next_tick) {
+    /* the pending timer interrupt accounts for the last elapsed tick */
+    os_size_t elapsed =
+        (os_size_t)((now - os_port_next_tick) / OS_PORT_TICK_PERIOD);
+    os_port_next_tick += (os_u64_t)elapsed * OS_PORT_TICK_PERIOD;
+    os_systick_advance(elapsed);
+  }
+  _set_mtimecmp(os_port_next_tick);
+
+  OS_ENABLE_INTERRUPTS();
+  os_schedule();
+}
+#endif
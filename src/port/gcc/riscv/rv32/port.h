@@ -0,0 +1,146 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OS_TRUE 1U
+#define OS_FALSE 0U
+#define OS_NULL ((void *)0)
+
+typedef unsigned char os_bool_t;
+
+typedef unsigned char os_u8_t;
+typedef unsigned short int os_u16_t;
+typedef unsigned long int os_u32_t;
+typedef unsigned long long int os_u64_t;
+typedef signed char os_i8_t;
+typedef signed short int os_i16_t;
+typedef signed long int os_i32_t;
+typedef signed long long int os_i64_t;
+
+typedef float os_f32_t;
+typedef double os_f64_t;
+
+typedef os_u32_t os_reg_t;
+typedef os_u32_t os_size_t;
+typedef os_u32_t os_stack_t;
+
+/**
+ * @brief Frequency of the CLINT mtime counter, 10 MHz on QEMU virt.
+ */
+#ifndef OS_PORT_MTIME_HZ
+#define OS_PORT_MTIME_HZ 10000000UL
+#endif
+
+/**
+ * @brief Systick frequency.
+ */
+#ifndef OS_PORT_TICK_HZ
+#define OS_PORT_TICK_HZ 1000UL
+#endif
+
+/**
+ * @brief This macro converts _bytes to an amount of os_stack_t entries.
+ */
+#define OS_PORT_BYTES_TO_SECTORS(_bytes) (_bytes >> 2)
+
+/**
+ * @brief Orders memory accesses, e.g. between a producer and a consumer
+ * that don't share a critical section.
+ */
+#define OS_MEMORY_BARRIER()                                                    \
+  do {                                                                         \
+    __asm volatile("fence rw, rw" ::: "memory");                               \
+  } while (0)
+
+#define OS_DISABLE_INTERRUPTS()                                                \
+  do {                                                                         \
+    __asm volatile("csrci mstatus, 8" ::: "memory");                           \
+  } while (0)
+
+#define OS_ENABLE_INTERRUPTS()                                                 \
+  do {                                                                         \
+    __asm volatile("csrsi mstatus, 8" ::: "memory");                           \
+  } while (0)
+
+/**
+ * @brief Call this macro at the entry of each function that has any critical
+ * sections.
+ */
+#define OS_DECLARE_CRITICAL() os_reg_t os_critical = 0;
+
+/**
+ * @brief   Call this macro to enter a critical section.
+ * @note    It requires OS_DECLARE_CRITICAL() to be called at the entry of the
+ * function.
+ */
+#define OS_ENTER_CRITICAL()                                                    \
+  do {                                                                         \
+    os_critical = os_port_enter_critical();                                    \
+  } while (0)
+
+/**
+ * @brief   Call this macro to exit a critical section.
+ * @note    It requires OS_DECLARE_CRITICAL() to be called at the entry of the
+ * function.
+ */
+#define OS_EXIT_CRITICAL()                                                     \
+  do {                                                                         \
+    os_port_exit_critical(os_critical);                                        \
+  } while (0)
+
+/**
+ * @brief This function is specific to this port of osrtos. Use
+ * OS_ENTER_CRITICAL() for better portability.
+ * @return os_reg_t - value of mstatus.MIE upon entering the critical section
+ */
+static inline os_reg_t os_port_enter_critical(void) {
+  os_reg_t mstatus;
+  __asm volatile("csrrci %0, mstatus, 8" : "=r"(mstatus) : : "memory");
+  return mstatus & 8U;
+}
+
+/**
+ * @brief This function is specific to this port of osrtos. Use
+ * OS_EXIT_CRITICAL() for better portability.
+ * @param mie - value of mstatus.MIE to restore
+ */
+static inline void os_port_exit_critical(os_reg_t mie) {
+  /* sets MIE back only if it was set */
+  __asm volatile("csrs mstatus, %0" : : "r"(mie) : "memory");
+}
+
+/**
+ * @brief Machine trap handler used by osrtos.
+ *
+ * It's installed in mtvec (direct mode) by os_port_startup(). It saves the
+ * whole context of the interrupted task, handles the machine timer (systick)
+ * and software (context switch) interrupts on a separate stack, and resumes
+ * whichever task is current afterwards.
+ */
+void os_port_trap_handler(void);
+
+/**
+ * @brief Puts the hart to sleep with the timer interrupt postponed until the
+ * nearest timeout, then catches up the elapsed ticks.
+ *
+ * It's called by the idle task when OS_CFG_ENABLE_TICKLESS_IDLE is set.
+ */
+void os_port_tickless_idle(void);
+
+/**
+ * @brief Starts the free-running counter read by os_port_get_cycles(). It does
+ * nothing on this port, mcycle is always running.
+ */
+void os_port_cycle_counter_init(void);
+
+/**
+ * @brief Reads the free-running cycle counter, the low word of mcycle.
+ * @return os_u32_t - current count, wrapping around at 2^32
+ */
+os_u32_t os_port_get_cycles(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,58 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OS_PORT_CLINT_MSIP_REG *((volatile os_u32_t *)0x02000000UL)
+#define OS_PORT_CLINT_MTIMECMP_LO_REG *((volatile os_u32_t *)0x02004000UL)
+#define OS_PORT_CLINT_MTIMECMP_HI_REG *((volatile os_u32_t *)0x02004004UL)
+#define OS_PORT_CLINT_MTIME_LO_REG *((volatile os_u32_t *)0x0200bff8UL)
+#define OS_PORT_CLINT_MTIME_HI_REG *((volatile os_u32_t *)0x0200bffcUL)
+
+#define OS_PORT_MSTATUS_MPIE_BIT (1UL << 7UL)
+#define OS_PORT_MSTATUS_MPP_M (3UL << 11UL)
+#define OS_PORT_MIE_MSIE_BIT (1UL << 3UL)
+#define OS_PORT_MIE_MTIE_BIT (1UL << 7UL)
+#define OS_PORT_MCAUSE_MSI (0x80000003UL)
+#define OS_PORT_MCAUSE_MTI (0x80000007UL)
+
+#define OS_PORT_TICK_PERIOD (OS_PORT_MTIME_HZ / OS_PORT_TICK_HZ)
+
+/**
+ * @brief   Layout of the context saved by the trap handler, in words. Every
+ *          register but zero, sp, gp and tp is saved, xN at index N - 4,
+ *          except ra at index 0. The frame is kept 16-byte aligned.
+ */
+#define OS_PORT_FRAME_RA 0U
+#define OS_PORT_FRAME_A0 6U
+#define OS_PORT_FRAME_MEPC 28U
+#define OS_PORT_FRAME_MSTATUS 29U
+#define OS_PORT_FRAME_WORDS 32U
+
+#define OS_CTX_SWITCH() os_port_context_switch()
+#define OS_CTX_SWITCH_FROM_ISR() os_port_context_switch()
+
+/** @brief This function raises the machine software interrupt. */
+void os_port_context_switch(void);
+
+/**
+ * @brief   Handles a trap, called by os_port_trap_handler() on the trap stack.
+ * @param   [in] mcause - cause of the trap
+ */
+void os_port_trap(os_reg_t mcause);
+
+/**
+ * @brief   Restores the context of os_curr_task and returns to it.
+ */
+void os_port_restore_context(void);
+
+/**
+ * @brief Gets the index of the highest set bit of a non-zero 32-bit word.
+ * @note  Without the Zbb extension it's a libgcc table lookup.
+ */
+#define OS_GET_HIGHEST_PRIORITY(_priorities) (31UL - __builtin_clz(_priorities))
+
+#ifdef __cplusplus
+}
+#endif
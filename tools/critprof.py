@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""Ranks critical section call sites by how long they mask interrupts.
+
+Build with OS_CFG_ENABLE_CRITICAL_PROFILER and print the sites passed to
+os_critical_profile_dump() as
+    critical <file>:<line> <count> <total> <max>
+e.g. with seal_bench configured with -DSEAL_BENCH_CRITICAL=ON:
+    ./seal_bench | tools/critprof.py --hz 1e9
+
+Lines that don't match are ignored, so the whole output of a run can be piped
+in. A site printed more than once, e.g. by several dumps, is summed up.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+LINE = re.compile(r"^critical (\S+):(\d+) (\d+) (\d+) (\d+)\s*$")
+
+
+def parse(lines):
+    """Returns {(file, line): [count, total, max]} for the site lines."""
+    sites = {}
+    for text in lines:
+        match = LINE.match(text)
+        if not match:
+            continue
+        path, line, count, total, worst = match.groups()
+        site = sites.setdefault((path, int(line)), [0, 0, 0])
+        site[0] += int(count)
+        site[1] += int(total)
+        site[2] = max(site[2], int(worst))
+    return sites
+
+
+def shorten(path):
+    """Strips everything up to the repo's top-level directories."""
+    parts = path.replace("\\", "/").split("/")
+    for top in ("src", "examples"):
+        if top in parts:
+            return "/".join(parts[len(parts) - parts[::-1].index(top) - 1:])
+    return os.path.basename(path)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("output", nargs="?",
+                        help="file with the dumped sites, stdin by default")
+    parser.add_argument("--hz", type=float, default=1e9,
+                        help="os_port_get_cycles() frequency, 1e9 on POSIX")
+    parser.add_argument("--sort", choices=("max", "total", "count"),
+                        default="max", help="ranking key, max by default")
+    parser.add_argument("--top", type=int, default=0,
+                        help="amount of sites shown, all by default")
+    args = parser.parse_args()
+
+    if args.output:
+        with open(args.output) as file:
+            sites = parse(file)
+    else:
+        sites = parse(sys.stdin)
+    if not sites:
+        sys.exit("no critical section sites found")
+
+    key = {"count": 0, "total": 1, "max": 2}[args.sort]
+    ranked = sorted(sites.items(), key=lambda item: item[1][key], reverse=True)
+    if args.top:
+        ranked = ranked[:args.top]
+
+    us = 1e6 / args.hz
+    print("%-36s %10s %12s %10s %10s" % ("site", "count", "total us",
+                                         "avg us", "max us"))
+    for (path, line), (count, total, worst) in ranked:
+        avg = total / count if count else 0
+        print("%-36s %10d %12.3f %10.3f %10.3f" % (
+            "%s:%d" % (shorten(path), line), count, total * us, avg * us,
+            worst * us))
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except BrokenPipeError:
+        # the reader, e.g. head, is gone; keep the exit flush from failing too
+        os.dup2(os.open(os.devnull, os.O_WRONLY), sys.stdout.fileno())
+        sys.exit(1)
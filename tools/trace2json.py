@@ -0,0 +1,270 @@
+#!/usr/bin/env python3
+"""Converts a dump of os_trace_buffer into Chrome trace JSON.
+
+Dump the buffer from a running target, e.g. in GDB:
+    dump binary value trace.bin os_trace_buffer
+or from the QEMU monitor, with the address and size taken from nm:
+    pmemsave <address> <size> trace.bin
+
+Then convert it and open the result in https://ui.perfetto.dev or
+chrome://tracing:
+    tools/trace2json.py trace.bin --hz 72000000 \\
+        --config examples/bench/bench_config.h -o trace.json
+
+Without -o the JSON is written to stdout. The config is expanded with the C
+preprocessor ($CPP, cpp by default), so tasks generated by macros get their
+names too. Pass it the -D switches of the build with -D.
+
+Each task gets a track with the slices where it ran and with its take, give,
+notify and block events. Blocking shows up as an async "blocked on" slice that
+ends when the task is switched in again, and priority changes as a per-task
+counter. Interrupts and systicks have their own track.
+"""
+
+import argparse
+import json
+import os
+import re
+import shlex
+import struct
+import subprocess
+import sys
+
+OS_TRACE_MAGIC = 0x5EA17ACE
+OS_TRACE_NO_TASK = 0xFF
+
+# Mirrors os_trace_event_t in src/inc/private.h.
+(
+    SWITCH,
+    SCHEDULE,
+    ISR_ENTER,
+    ISR_EXIT,
+    SYSTICK,
+    MUTEX_TAKE,
+    MUTEX_BLOCK,
+    MUTEX_GIVE,
+    SEMAPHORE_TAKE,
+    SEMAPHORE_BLOCK,
+    SEMAPHORE_GIVE,
+    PRIORITY,
+    TIMEOUT,
+    NOTIFY,
+    NOTIFY_BLOCK,
+    RWLOCK_READ,
+    RWLOCK_WRITE,
+    RWLOCK_BLOCK,
+    RWLOCK_GIVE,
+) = range(19)
+
+TAKES = (MUTEX_TAKE, SEMAPHORE_TAKE)
+GIVES = (MUTEX_GIVE, SEMAPHORE_GIVE, RWLOCK_GIVE)
+BLOCKS = (MUTEX_BLOCK, SEMAPHORE_BLOCK, RWLOCK_BLOCK)
+
+# Event ids are enumerated in this order by config.h.
+EVENT_KINDS = ("MUTEX", "SEMAPHORE", "MSGQ", "RING", "FLAGS", "POOL",
+               "RWLOCK")
+
+PID = 1
+ISR_TID = 1000
+KERNEL_TID = 1001
+
+
+def _expand_config(path, defines):
+    """Returns the object lists of an app config expanded by the C
+    preprocessor, or None when it can't be run."""
+    kinds = ("TASK",) + EVENT_KINDS
+    source = ['#include "%s"' % os.path.abspath(path)]
+    source += ["#define OS_%s(...) @%s __VA_ARGS__ @" % (k, k) for k in kinds]
+    source += ["OS_%s_DEFINITIONS" % k for k in kinds]
+    command = shlex.split(os.environ.get("CPP", "cpp")) + ["-P", "-"]
+    command += ["-D" + define for define in defines]
+    try:
+        result = subprocess.run(
+            command, input="\n".join(source) + "\n", stdout=subprocess.PIPE,
+            stderr=subprocess.DEVNULL, universal_newlines=True, check=True)
+        return result.stdout
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def parse_config(path, defines):
+    """Returns task and event names, in id order, from an app config."""
+    text = _expand_config(path, defines)
+    if text is None:
+        # without a preprocessor, entries generated by macros are missed
+        with open(path) as file:
+            text = file.read()
+        pattern = r"\bOS_%s\(\s*(OS_\w+)"
+    else:
+        pattern = r"@%s\s+(OS_\w+)"
+
+    def ids(kind):
+        names = re.findall(pattern % kind, text)
+        prefix = "OS_%s_ID_" % kind
+        return [n[len(prefix):] if n.startswith(prefix) else n for n in names]
+
+    events = []
+    for kind in EVENT_KINDS:
+        events += ids(kind)
+    return ids("TASK"), events
+
+
+def read_records(path):
+    """Returns the records of a dump, oldest first."""
+    with open(path, "rb") as file:
+        data = file.read()
+    header = struct.Struct("<IHHI")
+    magic, depth, record_size, head = header.unpack_from(data)
+    if magic != OS_TRACE_MAGIC:
+        sys.exit("%s: not a trace dump (magic 0x%08x)" % (path, magic))
+    record = struct.Struct("<IBBH")
+    if record_size != record.size:
+        sys.exit("%s: unexpected record size %d" % (path, record_size))
+    records = [
+        record.unpack_from(data, header.size + i * record.size)
+        for i in range(depth)
+    ]
+    if head <= depth:
+        return records[:head]
+    start = head % depth
+    return records[start:] + records[:start]
+
+
+def convert(records, hz, tasks, events):
+    def task_name(tid):
+        if tid == OS_TRACE_NO_TASK:
+            return "startup"
+        return tasks[tid] if tid < len(tasks) else "task %d" % tid
+
+    def event_name(eid):
+        return events[eid] if eid < len(events) else "event %d" % eid
+
+    out = []
+    seen = set()
+
+    def emit(ev):
+        ev["pid"] = PID
+        out.append(ev)
+        seen.add(ev["tid"])
+
+    def instant(ts, tid, name, args=None):
+        ev = {"ph": "i", "s": "t", "ts": ts, "tid": tid, "name": name}
+        if args:
+            ev["args"] = args
+        emit(ev)
+
+    now = 0
+    last = records[0][0] if records else 0
+    running = records[0][2] if records else OS_TRACE_NO_TASK
+    run_start = 0.0
+    blocked = {}
+    isr_depth = 0
+
+    for stamp, kind, task, arg in records:
+        now += (stamp - last) & 0xFFFFFFFF
+        last = stamp
+        ts = now * 1e6 / hz
+
+        if kind == SWITCH:
+            emit({"ph": "X", "ts": run_start, "dur": ts - run_start,
+                  "tid": running, "name": task_name(running)})
+            running, run_start = arg, ts
+            if arg in blocked:
+                name, timed_out = blocked.pop(arg)
+                emit({"ph": "e", "cat": "blocked", "id": arg, "ts": ts,
+                      "tid": arg, "name": name,
+                      "args": {"timed_out": timed_out}})
+        elif kind == SCHEDULE:
+            instant(ts, KERNEL_TID, "schedule " + task_name(arg))
+        elif kind == ISR_ENTER:
+            isr_depth += 1
+            emit({"ph": "B", "ts": ts, "tid": ISR_TID,
+                  "name": "isr", "args": {"nesting": arg}})
+        elif kind == ISR_EXIT:
+            if isr_depth:
+                isr_depth -= 1
+                emit({"ph": "E", "ts": ts, "tid": ISR_TID})
+        elif kind == SYSTICK:
+            instant(ts, ISR_TID, "systick")
+        elif kind in TAKES:
+            instant(ts, task, "take " + event_name(arg))
+        elif kind == RWLOCK_READ:
+            instant(ts, task, "read " + event_name(arg))
+        elif kind == RWLOCK_WRITE:
+            instant(ts, task, "write " + event_name(arg))
+        elif kind in GIVES:
+            instant(ts, task, "give " + event_name(arg))
+        elif kind in BLOCKS or kind == NOTIFY_BLOCK:
+            if kind == NOTIFY_BLOCK:
+                name = "blocked on a notification"
+            else:
+                name = "blocked on " + event_name(arg)
+            blocked[task] = (name, False)
+            instant(ts, task, name)
+            emit({"ph": "b", "cat": "blocked", "id": task, "ts": ts,
+                  "tid": task, "name": name})
+        elif kind == PRIORITY:
+            target, prio = arg >> 8, arg & 0xFF
+            instant(ts, task, "priority of %s -> %d" % (task_name(target),
+                                                        prio))
+            emit({"ph": "C", "ts": ts, "tid": target,
+                  "name": "priority " + task_name(target),
+                  "args": {"priority": prio}})
+        elif kind == NOTIFY:
+            instant(ts, task, "notify " + task_name(arg))
+        elif kind == TIMEOUT:
+            instant(ts, KERNEL_TID, "timeout " + task_name(arg))
+            if arg in blocked:
+                blocked[arg] = (blocked[arg][0], True)
+
+    if records:
+        ts = now * 1e6 / hz
+        emit({"ph": "X", "ts": run_start, "dur": ts - run_start,
+              "tid": running, "name": task_name(running)})
+
+    names = {ISR_TID: "interrupts", KERNEL_TID: "scheduler"}
+    for tid in sorted(seen):
+        name = names.get(tid, task_name(tid))
+        out.append({"ph": "M", "pid": PID, "tid": tid, "name": "thread_name",
+                    "args": {"name": name}})
+        out.append({"ph": "M", "pid": PID, "tid": tid,
+                    "name": "thread_sort_index", "args": {"sort_index": tid}})
+    out.append({"ph": "M", "pid": PID, "name": "process_name",
+                "args": {"name": "seal"}})
+    return {"traceEvents": out, "displayTimeUnit": "ns"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dump", help="binary dump of os_trace_buffer")
+    parser.add_argument("--hz", type=float, default=1e9,
+                        help="os_port_get_cycles() frequency, 1e9 on POSIX")
+    parser.add_argument("--config",
+                        help="app config header, used to name tasks and events")
+    parser.add_argument("-D", dest="defines", action="append", default=[],
+                        metavar="NAME[=VALUE]",
+                        help="macro for the config, as passed to the build")
+    parser.add_argument("-o", "--output",
+                        help="JSON file to write, stdout by default")
+    args = parser.parse_args()
+
+    tasks, events = [], []
+    if args.config:
+        tasks, events = parse_config(args.config, args.defines)
+    trace = convert(read_records(args.dump), args.hz, tasks, events)
+    if args.output:
+        with open(args.output, "w") as file:
+            json.dump(trace, file, indent=None, separators=(",", ":"))
+            file.write("\n")
+    else:
+        json.dump(trace, sys.stdout, indent=None, separators=(",", ":"))
+        sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except BrokenPipeError:
+        # the reader, e.g. head, is gone; keep the exit flush from failing too
+        os.dup2(os.open(os.devnull, os.O_WRONLY), sys.stdout.fileno())
+        sys.exit(1)